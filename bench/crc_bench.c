@@ -0,0 +1,373 @@
+// crc_bench.c
+//
+// See crc_bench.h
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "crc_bench.h"
+#include "crc_port.h"
+#include "stm32crc.h"
+#include "crc_reflect.h"
+#include "crc_sw.h"
+#include "crc_ref.h"
+#include "crc_poly.h"
+
+#ifndef CRC_BENCH_FAMILY
+#define CRC_BENCH_FAMILY "unknown"
+#endif
+
+#ifndef CRC_BENCH_DMA
+#define CRC_BENCH_DMA 0
+#endif
+
+#if defined(CRC_BENCH_UA_PER_MHZ) && !defined(CRC_BENCH_MV)
+#define CRC_BENCH_MV 3000u
+#endif
+
+#if CRC_BENCH_DMA
+#include "crc_dma.h"
+#endif
+
+// Each measurement is repeated and the fastest kept, so that flash wait
+//  states and cache misses on the first run don't count
+#ifndef CRC_BENCH_REPEAT
+#define CRC_BENCH_REPEAT 3
+#endif
+
+#define CRC_BENCH_STR2(x) #x
+#define CRC_BENCH_STR(x) CRC_BENCH_STR2(x)
+
+// Cycle counter
+#if defined(CRC_BENCH_CYCLES)
+
+#define CRC_BENCH_MASK 0xFFFFFFFFu
+
+static void crcBenchTimerInit(void)
+{
+}
+
+#elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__)
+
+// M0, M0+ and M23 have no DWT cycle counter; use SysTick, which counts down
+//  from 0xFFFFFF at the core clock.  Intervals must be under 2^24 cycles.
+#define CRC_SYST_CSR (*(volatile uint32_t *)0xE000E010u)
+#define CRC_SYST_RVR (*(volatile uint32_t *)0xE000E014u)
+#define CRC_SYST_CVR (*(volatile uint32_t *)0xE000E018u)
+
+#define CRC_BENCH_CYCLES (0u - CRC_SYST_CVR)
+#define CRC_BENCH_MASK 0x00FFFFFFu
+
+static void crcBenchTimerInit(void)
+{
+    CRC_SYST_RVR = 0x00FFFFFFu;
+    CRC_SYST_CVR = 0;
+    CRC_SYST_CSR = 5u;                  // core clock, enabled, no interrupt
+}
+
+#else
+
+#define CRC_DEMCR      (*(volatile uint32_t *)0xE000EDFCu)
+#define CRC_DWT_CTRL   (*(volatile uint32_t *)0xE0001000u)
+#define CRC_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004u)
+#define CRC_DWT_LAR    (*(volatile uint32_t *)0xE0001FB0u)
+
+#define CRC_BENCH_CYCLES CRC_DWT_CYCCNT
+#define CRC_BENCH_MASK 0xFFFFFFFFu
+
+static void crcBenchTimerInit(void)
+{
+    CRC_DEMCR |= 1u << 24;              // TRCENA
+    CRC_DWT_LAR = 0xC5ACCE55u;          // unlock; needed on M7, ignored elsewhere
+    CRC_DWT_CYCCNT = 0;
+    CRC_DWT_CTRL |= 1u;                 // CYCCNTENA
+}
+
+#endif
+
+#if defined(__ARM_ARCH_6M__)
+#define CRC_BENCH_CORE "v6-M"
+#elif defined(__ARM_ARCH_7M__)
+#define CRC_BENCH_CORE "v7-M"
+#elif defined(__ARM_ARCH_7EM__)
+#define CRC_BENCH_CORE "v7E-M"
+#elif defined(__ARM_ARCH_8M_MAIN__) || defined(__ARM_ARCH_8M_BASE__)
+#define CRC_BENCH_CORE "v8-M"
+#else
+#define CRC_BENCH_CORE "other"
+#endif
+
+typedef uint32_t (*CrcBenchFn)(const uint8_t *p, size_t len);
+
+typedef struct
+{
+    const char *name;
+    CrcBenchFn fn;
+} CrcBenchPath;
+
+static uint32_t crcBenchHwBytes(const uint8_t *p, size_t len)
+{
+    return crcCalc(p, len, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+}
+
+static uint32_t crcBenchHwWords(const uint8_t *p, size_t len)
+{
+    return crcCalc(p, len, 0xFFFFFFFFu, CRC_ORDER_WORDS);
+}
+
+static uint32_t crcBenchHwHalfwords(const uint8_t *p, size_t len)
+{
+    return crcCalc(p, len, 0xFFFFFFFFu, CRC_ORDER_HALFWORDS);
+}
+
+#if CRC_USE_TAIL_TABLE
+// The same as hw_bytes and hw_words, with partial words done by table
+static uint32_t crcBenchHwTable(const uint8_t *p, size_t len, CrcOrder order)
+{
+    CrcCtx ctx;
+
+    crcInit(&ctx, 0xFFFFFFFFu, order);
+    crcSetTail(&ctx, CRC_TAIL_TABLE);
+    crcUpdate(&ctx, p, len);
+    return crcFinal(&ctx);
+}
+
+static uint32_t crcBenchHwBytesTable(const uint8_t *p, size_t len)
+{
+    return crcBenchHwTable(p, len, CRC_ORDER_BYTES);
+}
+
+static uint32_t crcBenchHwWordsTable(const uint8_t *p, size_t len)
+{
+    return crcBenchHwTable(p, len, CRC_ORDER_WORDS);
+}
+#endif
+
+// The buffer as 16-byte frames (the last one shorter), one crcCalc() each
+//  or all in one crcCalcBatch()
+#define CRC_BENCH_FRAME 16u
+#define CRC_BENCH_MAX_FRAMES 260u
+
+static uint32_t crcBenchFrames(const uint8_t *p, size_t len)
+{
+    uint32_t x = 0;
+
+    for (size_t at = 0; at < len; at += CRC_BENCH_FRAME)
+    {
+        size_t n = (len - at < CRC_BENCH_FRAME) ? len - at : CRC_BENCH_FRAME;
+        x ^= crcCalc(p + at, n, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+    }
+    return x;
+}
+
+static uint32_t crcBenchBatch(const uint8_t *p, size_t len)
+{
+    static CrcIovec msg[CRC_BENCH_MAX_FRAMES];
+    static uint32_t crc[CRC_BENCH_MAX_FRAMES];
+    size_t count = 0;
+
+    for (size_t at = 0; at < len; at += CRC_BENCH_FRAME)
+    {
+        msg[count].base = p + at;
+        msg[count].len = (len - at < CRC_BENCH_FRAME) ? len - at : CRC_BENCH_FRAME;
+        count++;
+    }
+    crcCalcBatch(msg, count, 0xFFFFFFFFu, CRC_ORDER_BYTES, crc);
+    return count ? crc[count - 1] : 0;
+}
+
+static uint32_t crcBenchHwReflected(const uint8_t *p, size_t len)
+{
+    return crc32Zlib(p, len);
+}
+
+#if CRC_BENCH_DMA
+static volatile int crcBenchDmaDone;
+
+static void crcBenchDmaCallback(CrcCtx *ctx, void *arg)
+{
+    (void)ctx;
+    (void)arg;
+    crcBenchDmaDone = 1;
+}
+
+// Time to completion, including the CPU waiting for the DMA
+static uint32_t crcBenchHwDma(const uint8_t *p, size_t len)
+{
+    CrcCtx ctx;
+
+    crcBenchDmaDone = 0;
+    crcInit(&ctx, 0xFFFFFFFFu, CRC_ORDER_WORDS);
+    crcUpdateDma(&ctx, p, len, crcBenchDmaCallback, NULL);
+    while (!crcBenchDmaDone)
+    {
+    }
+    return crcFinal(&ctx);
+}
+#endif
+
+static uint32_t crcBenchSw(const uint8_t *p, size_t len)
+{
+    return crcSwCalc(p, len, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+}
+
+// The buffer as CRC_SW_STREAMS separate buffers, fed interleaved; compare
+//  with sw_slice for the gain from overlapping the streams' lookups
+static uint32_t crcBenchSwStreams(const uint8_t *p, size_t len)
+{
+    CrcSwStream s[CRC_SW_STREAMS];
+    size_t part = len / CRC_SW_STREAMS;
+    uint32_t crc = 0;
+
+    for (unsigned k = 0; k < CRC_SW_STREAMS; k++)
+    {
+        s[k].data = p + part * k;
+        s[k].len = (k < CRC_SW_STREAMS - 1) ? part : len - part * k;
+        s[k].crcReg = 0xFFFFFFFFu;
+    }
+    crcSwUpdateStreams(s, CRC_SW_STREAMS, CRC_ORDER_BYTES);
+    for (unsigned k = 0; k < CRC_SW_STREAMS; k++)
+    {
+        crc ^= s[k].crcReg;
+    }
+    return crc;
+}
+
+static uint32_t crcBenchClever(const uint8_t *p, size_t len)
+{
+    return cleverCRC(0xFFFFFFFFu, p, len);
+}
+
+// CRC-32C: the table against whatever crcPolyCalc() picks, which is also
+//  the table unless the peripheral has a programmable polynomial
+static CrcPoly crcBenchCrc32C;
+
+static uint32_t crcBenchCrc32CSw(const uint8_t *p, size_t len)
+{
+    return crcPolySwCalc(&crcBenchCrc32C, p, len);
+}
+
+static uint32_t crcBenchCrc32CAuto(const uint8_t *p, size_t len)
+{
+    return crcPolyCalc(&crcBenchCrc32C, p, len);
+}
+
+static uint32_t crcBenchNothing(const uint8_t *p, size_t len)
+{
+    (void)len;
+    return (uint32_t)(uintptr_t)p;
+}
+
+static const CrcBenchPath crcBenchPaths[] =
+{
+    { "hw_bytes",     crcBenchHwBytes },
+    { "hw_words",     crcBenchHwWords },
+    { "hw_halfwords", crcBenchHwHalfwords },
+#if CRC_USE_TAIL_TABLE
+    { "hw_bytes_tabletail", crcBenchHwBytesTable },
+    { "hw_words_tabletail", crcBenchHwWordsTable },
+#endif
+    { "hw_frames16",  crcBenchFrames },
+    { "hw_batch16",   crcBenchBatch },
+    { "hw_reflected", crcBenchHwReflected },
+#if CRC_BENCH_DMA
+    { "hw_dma",       crcBenchHwDma },
+#endif
+#if CRC_SW_SLICE == 0
+    { "sw_nibble",    crcBenchSw },
+#else
+    { "sw_slice" CRC_BENCH_STR(CRC_SW_SLICE), crcBenchSw },
+#endif
+    { "sw_streams" CRC_BENCH_STR(CRC_SW_STREAMS), crcBenchSwStreams },
+    { "clever",       crcBenchClever },
+    { "crc32c_sw",    crcBenchCrc32CSw },
+    { "crc32c_auto",  crcBenchCrc32CAuto },
+};
+
+// Sizes before adding the 0..3 tail bytes
+static const uint16_t crcBenchSizes[] = { 4, 16, 64, 256, 1024, 4096 };
+
+#define CRC_BENCH_MAX_SIZE (4096 + 3)
+
+static uint32_t crcBenchBuf[(CRC_BENCH_MAX_SIZE + 3 + 3) / 4];
+static volatile uint32_t crcBenchSink;
+static uint32_t crcBenchOverhead;
+
+static uint32_t crcBenchMeasure(CrcBenchFn fn, const uint8_t *p, size_t len)
+{
+    uint32_t best = 0xFFFFFFFFu;
+
+    for (int r = 0; r < CRC_BENCH_REPEAT; r++)
+    {
+        uint32_t start = CRC_BENCH_CYCLES;
+        crcBenchSink = fn(p, len);
+        uint32_t cycles = (CRC_BENCH_CYCLES - start) & CRC_BENCH_MASK;
+
+        if (cycles < best)
+        {
+            best = cycles;
+        }
+    }
+
+    return (best > crcBenchOverhead) ? best - crcBenchOverhead : 0;
+}
+
+// Print cycles per byte with two decimal places; printf() often has no
+//  floating point support on the target
+static void crcBenchPrint(const char *path, size_t len, unsigned start, uint32_t cycles)
+{
+    uint32_t perByte100 = (uint32_t)(((uint64_t)cycles * 100u + len / 2) / len);
+
+    printf("%s,%s,%s,%lu,%u,%u,%lu,%lu.%02lu,",
+           CRC_BENCH_FAMILY, CRC_BENCH_CORE, path,
+           (unsigned long)len, start, (unsigned)(len & 3),
+           (unsigned long)cycles,
+           (unsigned long)(perByte100 / 100), (unsigned long)(perByte100 % 100));
+
+#if defined(CRC_BENCH_UA_PER_MHZ)
+    // One cycle at I/f = CRC_BENCH_UA_PER_MHZ uA/MHz takes that many pC, so
+    //  1 mV * 1 uA/MHz is 1e-6 nJ per cycle
+    uint64_t pj = (uint64_t)cycles * 1024u * CRC_BENCH_MV * CRC_BENCH_UA_PER_MHZ / 1000u;
+    printf("%lu\n", (unsigned long)((pj / len + 500u) / 1000u));
+#else
+    printf("\n");
+#endif
+}
+
+void crcBench(void)
+{
+    uint8_t *buf = (uint8_t *)crcBenchBuf;
+    uint32_t x = 0x12345678u;
+
+    // Any data will do, as long as it isn't all zeros
+    for (size_t i = 0; i < sizeof crcBenchBuf; i++)
+    {
+        x = x * 1664525u + 1013904223u;
+        buf[i] = (uint8_t)(x >> 24);
+    }
+
+    crcPolyInit(&crcBenchCrc32C, &crcParamsCrc32C);
+
+    crcBenchTimerInit();
+    crcBenchOverhead = 0;
+    crcBenchOverhead = crcBenchMeasure(crcBenchNothing, buf, 0);
+
+    printf("family,core,path,size,start,tail,cycles,cycles_per_byte,nj_per_kb\n");
+
+    for (size_t i = 0; i < sizeof crcBenchPaths / sizeof crcBenchPaths[0]; i++)
+    {
+        for (size_t s = 0; s < sizeof crcBenchSizes / sizeof crcBenchSizes[0]; s++)
+        {
+            for (unsigned start = 0; start < 4; start++)
+            {
+                for (unsigned tail = 0; tail < 4; tail++)
+                {
+                    size_t len = crcBenchSizes[s] + tail;
+                    uint32_t cycles = crcBenchMeasure(crcBenchPaths[i].fn, buf + start, len);
+
+                    crcBenchPrint(crcBenchPaths[i].name, len, start, cycles);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+// crc_bench.h
+//
+// Cycle-count benchmarks for every CRC path in src/, to run on the target.
+//
+// Call crcBench() from main() once the clocks, the CRC peripheral clock and
+// printf() output (e.g. a UART or semihosting) are set up.  Results are
+// printed as CSV, one line per measurement:
+//
+//     family,core,path,size,start,tail,cycles,cycles_per_byte,nj_per_kb
+//
+// where start is the buffer's offset from a word boundary, the "Start
+// Address" case, and tail is size % 4, the "End Address" case.  nj_per_kb
+// is an estimate of the energy per 1024 bytes in nanojoules, from the
+// cycles and the datasheet's run-mode current; it is left empty unless
+// CRC_BENCH_UA_PER_MHZ is set.  It counts the core running throughout, so
+// for DMA paths, where the core could be asleep (see crc_lowpower.h), it is
+// an upper bound.
+//
+// Build options:
+//   CRC_BENCH_FAMILY  string naming the part, e.g. "F4" (printed as is)
+//   CRC_BENCH_DMA     1 to include the DMA path (needs crcPortDmaStart())
+//   CRC_BENCH_CYCLES  expression giving a free-running cycle count, if the
+//                     DWT/SysTick code below doesn't suit
+//   CRC_BENCH_UA_PER_MHZ  run-mode supply current in uA/MHz at the clock
+//                     and flash settings used, e.g. 84 for an L4 running
+//                     from flash; gives the nj_per_kb column
+//   CRC_BENCH_MV      supply voltage in mV for nj_per_kb (default 3000)
+//
+// To run it on a PC with host/crc_sim.h as the peripheral, build with
+// -DCRC_PORT_HEADER='"crc_sim.h"' -DCRC_BENCH_CYCLES='crcSimCycles()'; the
+// "cycles" are then nanoseconds.  For CRC_BENCH_DMA, call
+// crcSimSetDmaIrq(crcDmaIrqHandler) first.
+
+#ifndef CRC_BENCH_H
+#define CRC_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void crcBench(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_BENCH_H
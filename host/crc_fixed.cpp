@@ -0,0 +1,183 @@
+// crc_fixed.cpp
+//
+// Checks calcFixed<Align, Len, Order>() and calcObject() from stm32crc.hpp
+// against crcCalc() on the crc_sim.h model: every power-of-2 Align up to 8
+// at every start address it allows, every Len up to past the unrolled
+// limit (so every Len % 4, with and without the loop), and every CrcOrder.
+// calcObject() is checked on structs with padding, whose sizeof() takes in
+// the padding bytes.  hwCalcFixed() is checked against the table.
+//
+// The C sources are C99, so they are compiled separately.  Build (each as
+// one command) and run, from the top of the repo:
+//
+//     cc -O2 -std=c99 -Isrc -Ihost -DCRC_PORT_HEADER='"crc_sim.h"' -c
+//         host/crc_sim.c src/stm32crc.c src/crc_sw.c src/crc_sw_tables.c
+//     c++ -O2 -std=c++14 -Isrc -Ihost -DCRC_PORT_HEADER='"crc_sim.h"' -o crc_fixed
+//         host/crc_fixed.cpp crc_sim.o stm32crc.o crc_sw.o crc_sw_tables.o
+//     ./crc_fixed
+//
+// Prints the first few failures, and exits with status 1 if there were any.
+
+#include <stdio.h>
+
+#include <utility>
+
+#include "stm32crc.hpp"
+#include "crc_sim.h"
+
+namespace
+{
+
+constexpr size_t maxLen = 4 * CRC_FIXED_UNROLL + 8;
+constexpr unsigned long maxFails = 20;
+
+unsigned long checks;
+unsigned long fails;
+
+alignas(8) uint8_t buf[8 + maxLen];
+
+const uint32_t inits[] = { 0xFFFFFFFFu, 0, 0x12345678u };
+
+void check(const char *what, uint32_t got, uint32_t want, size_t offset, size_t len,
+           uint32_t init, CrcOrder order)
+{
+    checks++;
+    if (got == want)
+    {
+        return;
+    }
+    if (fails < maxFails)
+    {
+        printf("FAIL %s: offset %lu len %lu init %08lX order %d: got %08lX want %08lX\n",
+               what, (unsigned long)offset, (unsigned long)len, (unsigned long)init, (int)order,
+               (unsigned long)got, (unsigned long)want);
+    }
+    fails++;
+}
+
+// Every start in buf aligned to Align bytes
+template <unsigned Align, CrcOrder Order, size_t Len>
+void checkFixed()
+{
+    for (size_t at = 0; at < 8; at += Align)
+    {
+        for (uint32_t init : inits)
+        {
+            check("calcFixed", stm32crc::calcFixed<Align, Len, Order>(buf + at, init),
+                  crcCalc(buf + at, Len, init, Order), at, Len, init, Order);
+        }
+    }
+}
+
+template <unsigned Align, CrcOrder Order, size_t... Len>
+void checkLens(std::index_sequence<Len...>)
+{
+    int each[] = { (checkFixed<Align, Order, Len>(), 0)... };
+    (void)each;
+}
+
+template <CrcOrder Order>
+void checkAligns()
+{
+    checkLens<1, Order>(std::make_index_sequence<maxLen + 1>());
+    checkLens<2, Order>(std::make_index_sequence<maxLen + 1>());
+    checkLens<4, Order>(std::make_index_sequence<maxLen + 1>());
+    checkLens<8, Order>(std::make_index_sequence<maxLen + 1>());
+}
+
+// Padded so that sizeof() isn't the sum of the members
+struct WordByte
+{
+    uint32_t a;
+    uint8_t b;
+};
+
+struct ByteHalfByte
+{
+    uint8_t a;
+    uint16_t b;
+    uint8_t c;
+};
+
+struct Bytes7
+{
+    uint8_t a[7];
+};
+
+static_assert(sizeof(WordByte) == 8 && alignof(WordByte) == 4, "WordByte padding");
+static_assert(sizeof(ByteHalfByte) == 6 && alignof(ByteHalfByte) == 2, "ByteHalfByte padding");
+
+WordByte wordByte[3];
+ByteHalfByte byteHalfByte[3];       // every other one off a word boundary
+Bytes7 bytes7[4];                   // at every offset in a word
+
+// Fill the objects, padding and all, with a pattern that isn't zero
+template <typename T, size_t N>
+void fill(T (&obj)[N], uint8_t seed)
+{
+    uint8_t *p = reinterpret_cast<uint8_t *>(obj);
+    for (size_t i = 0; i < sizeof obj; i++)
+    {
+        p[i] = static_cast<uint8_t>(seed + 37 * i);
+    }
+}
+
+template <CrcOrder Order, typename T, size_t N>
+void checkObjects(const T (&obj)[N])
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        for (uint32_t init : inits)
+        {
+            check("calcObject", stm32crc::calcObject<Order>(obj[i], init),
+                  crcCalc(&obj[i], sizeof obj[i], init, Order), i * sizeof obj[i],
+                  sizeof obj[i], init, Order);
+        }
+    }
+}
+
+template <CrcOrder Order>
+void checkObjects()
+{
+    checkObjects<Order>(wordByte);
+    checkObjects<Order>(byteHalfByte);
+    checkObjects<Order>(bytes7);
+}
+
+template <size_t Len>
+void checkHw()
+{
+    check("Crc32Mpeg2::hwCalcFixed", stm32crc::Crc32Mpeg2::hwCalcFixed<4, Len>(buf),
+          stm32crc::Crc32Mpeg2::calc(buf, Len), 0, Len, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+    check("Crc32Bzip2::hwCalcFixed", stm32crc::Crc32Bzip2::hwCalcFixed<4, Len>(buf),
+          stm32crc::Crc32Bzip2::calc(buf, Len), 0, Len, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+}
+
+} // namespace
+
+int main()
+{
+    for (size_t i = 0; i < sizeof buf; i++)
+    {
+        buf[i] = static_cast<uint8_t>(0xA5 ^ (29 * i));
+    }
+    fill(wordByte, 1);
+    fill(byteHalfByte, 2);
+    fill(bytes7, 3);
+
+    checkAligns<CRC_ORDER_BYTES>();
+    checkAligns<CRC_ORDER_WORDS>();
+    checkAligns<CRC_ORDER_HALFWORDS>();
+
+    checkObjects<CRC_ORDER_BYTES>();
+    checkObjects<CRC_ORDER_WORDS>();
+    checkObjects<CRC_ORDER_HALFWORDS>();
+
+    checkHw<0>();
+    checkHw<9>();
+    checkHw<64>();
+    checkHw<maxLen>();
+
+    printf("%lu checks, %lu failures\n", checks, fails);
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,883 @@
+// crc_fuzz.c
+//
+// Differential fuzzer: checks the fast paths in src/ and host/ against the
+// bit-at-a-time simpleCRC() and cleverCRC() from the doc, over random
+// lengths, alignments, initial values, orders and split points, and checks
+// the doc's worked examples as fixed vectors.
+//
+// The firmware code runs unchanged on the crc_sim.h model of the
+// peripheral.  The model's table core is checked along with everything
+// else, as all results are compared with the bit-at-a-time references.
+//
+// Build (as one command) and run, from the top of the repo:
+//
+//     cc -O2 -Isrc -Ihost -DCRC_PORT_HEADER='"crc_sim.h"' -o crc_fuzz
+//         host/crc_fuzz.c host/crc_sim.c host/crc_host.c src/stm32crc.c src/crc_ref.c
+//         src/crc_sw.c src/crc_sw_tables.c src/crc_combine.c src/crc_patch.c
+//         src/crc_reflect.c src/crc_dma.c src/crc_share.c src/crc_stripe.c
+//         src/crc_xip.c src/crc_log.c src/crc_prog.c src/crc_poly.c
+//         src/crc_queue.c src/crc_select.c src/crc_image.c src/crc_lowpower.c
+//     ./crc_fuzz [cases [seed]]
+//
+// Build it again with -DCRC_QUEUE_DMA=1 -DCRC_SELECT_DMA=1 to check the
+// queue's DMA service and crcBackendDma().
+//
+// Prints the first few failures, and exits with status 1 if there were any.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stm32crc.h"
+#include "crc_combine.h"
+#include "crc_dma.h"
+#include "crc_host.h"
+#include "crc_image.h"
+#include "crc_log.h"
+#include "crc_lowpower.h"
+#include "crc_patch.h"
+#include "crc_poly.h"
+#include "crc_port.h"
+#include "crc_prog.h"
+#include "crc_queue.h"
+#include "crc_ref.h"
+#include "crc_reflect.h"
+#include "crc_select.h"
+#include "crc_share.h"
+#include "crc_sim.h"
+#include "crc_stripe.h"
+#include "crc_xip.h"
+#include "crc_sw.h"
+
+#define CRC_FUZZ_MAX_LEN 4100u
+#define CRC_FUZZ_MAX_FAILS 20u
+
+static uint64_t crcFuzzState = 0x9E3779B97F4A7C15u;
+static unsigned long crcFuzzChecks;
+static unsigned long crcFuzzFails;
+
+static uint32_t crcFuzzBuf[(CRC_FUZZ_MAX_LEN + 16) / 4];
+static uint8_t crcFuzzTmp[CRC_FUZZ_MAX_LEN + 16];
+
+// xorshift64*
+static uint32_t crcFuzzRand(void)
+{
+    crcFuzzState ^= crcFuzzState >> 12;
+    crcFuzzState ^= crcFuzzState << 25;
+    crcFuzzState ^= crcFuzzState >> 27;
+    return (uint32_t)((crcFuzzState * 0x2545F4914F6CDD1Du) >> 32);
+}
+
+// Mostly short lengths, where the head and tail tricks matter most
+static size_t crcFuzzLen(void)
+{
+    switch (crcFuzzRand() % 8)
+    {
+    case 0:  return crcFuzzRand() % 8;
+    case 6:  return crcFuzzRand() % 600;
+    case 7:  return crcFuzzRand() % CRC_FUZZ_MAX_LEN;
+    default: return crcFuzzRand() % 80;
+    }
+}
+
+static uint32_t crcFuzzInit(void)
+{
+    switch (crcFuzzRand() % 4)
+    {
+    case 0:  return 0xFFFFFFFFu;
+    case 1:  return 0;
+    default: return crcFuzzRand();
+    }
+}
+
+static void crcFuzzCheck(const char *what, uint32_t got, uint32_t want,
+                         size_t offset, size_t len, uint32_t init, CrcOrder order)
+{
+    crcFuzzChecks++;
+    if (got == want)
+    {
+        return;
+    }
+    if (crcFuzzFails < CRC_FUZZ_MAX_FAILS)
+    {
+        printf("FAIL %s: offset %lu len %lu init %08lX order %d: got %08lX want %08lX\n",
+               what, (unsigned long)offset, (unsigned long)len, (unsigned long)init, (int)order,
+               (unsigned long)got, (unsigned long)want);
+    }
+    crcFuzzFails++;
+}
+
+static uint32_t crcFuzzReflect(uint32_t x)
+{
+    uint32_t r = 0;
+
+    for (int i = 0; i < 32; i++)
+    {
+        r = (r << 1) | ((x >> i) & 1u);
+    }
+    return r;
+}
+
+// The bytes of len bytes at p in the order they are processed, so that
+//  cleverCRC() of them is the expected CRC.  Partial words keep the order of
+//  whichever bytes are there, as described in stm32crc.h.
+static size_t crcFuzzOrdered(uint8_t *out, const uint8_t *p, size_t len, CrcOrder order)
+{
+    static const uint8_t seq[3][4] =
+    {
+        [CRC_ORDER_BYTES]     = { 0, 1, 2, 3 },
+        [CRC_ORDER_WORDS]     = { 3, 2, 1, 0 },
+        [CRC_ORDER_HALFWORDS] = { 1, 0, 3, 2 },
+    };
+    uintptr_t start = (uintptr_t)p;
+    uintptr_t end = start + len;
+    size_t n = 0;
+
+    for (uintptr_t w = start & ~(uintptr_t)3; w < end; w += 4)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            uintptr_t at = w + seq[order][i];
+            if (at >= start && at < end)
+            {
+                out[n++] = p[at - start];
+            }
+        }
+    }
+    return n;
+}
+
+static uint32_t crcFuzzRef(const uint8_t *p, size_t len, uint32_t init, CrcOrder order)
+{
+    size_t n = crcFuzzOrdered(crcFuzzTmp, p, len, order);
+
+    return cleverCRC(init, crcFuzzTmp, n);
+}
+
+// The standard reflected CRC, from cleverCRC() of the bit-reversed bytes
+static uint32_t crcFuzzRefReflected(const uint8_t *p, size_t len, uint32_t init)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        crcFuzzTmp[i] = (uint8_t)(crcFuzzReflect(p[i]) >> 24);
+    }
+    return crcFuzzReflect(cleverCRC(crcFuzzReflect(init), crcFuzzTmp, len));
+}
+
+// Up to 3 random cut points in [0, len], in order.  For the orders that
+//  aren't split-invariant the cuts are on word boundaries.
+static size_t crcFuzzCuts(size_t *cut, const uint8_t *p, size_t len, CrcOrder order)
+{
+    size_t n = crcFuzzRand() % 4;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t c = len ? crcFuzzRand() % (len + 1) : 0;
+        if (order != CRC_ORDER_BYTES)
+        {
+            c = (size_t)((((uintptr_t)p + c) & ~(uintptr_t)3) - (uintptr_t)p);
+            if (c > len)
+            {
+                c = 0;
+            }
+        }
+        cut[i] = c;
+    }
+
+    // Insertion sort
+    for (size_t i = 1; i < n; i++)
+    {
+        for (size_t j = i; j > 0 && cut[j - 1] > cut[j]; j--)
+        {
+            size_t t = cut[j];
+            cut[j] = cut[j - 1];
+            cut[j - 1] = t;
+        }
+    }
+    return n;
+}
+
+static void crcFuzzDmaDone(CrcCtx *ctx, void *arg)
+{
+    (void)ctx;
+    *(int *)arg = 1;
+}
+
+static uint32_t crcFuzzDma(const uint8_t *p, size_t len, uint32_t init, CrcOrder order)
+{
+    CrcCtx ctx;
+    int done = 0;
+
+    crcInit(&ctx, init, order);
+    crcUpdateDma(&ctx, p, len, crcFuzzDmaDone, &done);
+    while (!done)
+    {
+        if (crcSimDmaComplete())
+        {
+            crcDmaIrqHandler();
+        }
+    }
+    return crcFinal(&ctx);
+}
+
+// One stream at a time, so no locking is needed
+void crcPortLock(void)
+{
+}
+
+void crcPortUnlock(void)
+{
+}
+
+// The service is run by hand in crcFuzzQueue()
+void crcPortQueueKick(void)
+{
+}
+
+static int crcFuzzJobsDone;
+
+static void crcFuzzJobDone(uint32_t crc, void *arg)
+{
+    *(uint32_t *)arg = crc;
+    crcFuzzJobsDone++;
+}
+
+static int crcFuzzClockOn;
+
+void crcPortClock(int on)
+{
+    crcFuzzClockOn = on;
+}
+
+void crcPortLowPowerWake(uint32_t tick)
+{
+    (void)tick;
+}
+
+static CrcJob crcFuzzLpFollow;
+static uint32_t crcFuzzLpFollowCrc;
+
+// The first job's done function posts another, which is kept for the next
+//  batch
+static void crcFuzzLpDoneFirst(uint32_t crc, void *arg)
+{
+    crcFuzzJobDone(crc, arg);
+    crcFuzzCheck("crcLpPost from done", (uint32_t)crcLpPost(&crcFuzzLpFollow, 0), 0,
+                 0, crcFuzzLpFollow.len, crcFuzzLpFollow.initValue, crcFuzzLpFollow.order);
+}
+
+// Post the jobs, then run the service until they are all done, doing the
+//  DMA transfers as it asks for them
+static void crcFuzzQueue(CrcJob *job, size_t n)
+{
+    crcFuzzJobsDone = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        job[i].done = crcFuzzJobDone;
+        crcQueuePost(&job[i]);
+    }
+    crcQueueService();
+    while ((size_t)crcFuzzJobsDone < n)
+    {
+        if (crcSimDmaComplete())
+        {
+            crcDmaIrqHandler();
+        }
+    }
+}
+
+// The other engines run each stripe at once, alternately with the
+//  peripheral and the table
+void crcPortStripeStart(unsigned k, CrcStripe *s)
+{
+    if (k & 1u)
+    {
+        crcStripeRunSw(s);
+    }
+    else
+    {
+        crcStripeRun(s);
+    }
+}
+
+static uint32_t crcFuzzXip(const uint8_t *p, size_t len, uint32_t init, CrcOrder order)
+{
+    CrcCtx ctx;
+    int done = 0;
+
+    crcInit(&ctx, init, order);
+    crcUpdateXip(&ctx, p, len, crcFuzzDmaDone, &done);
+    while (!done)
+    {
+        if (crcSimDmaComplete())
+        {
+            crcDmaIrqHandler();
+        }
+    }
+    return crcFinal(&ctx);
+}
+
+// A log for each order, kept from case to case so that the window wraps
+//  round and records are evicted
+static uint32_t crcFuzzLogBuf[3][512 / 4];
+static CrcLogRecord crcFuzzLogRec[3][8];
+static CrcLog crcFuzzLogs[3];
+static uint8_t crcFuzzLogWindow[512];
+
+// Append up to 200 bytes at p to the log for order, and check the window
+static void crcFuzzLog(const uint8_t *p, size_t len, uint32_t init, CrcOrder order)
+{
+    CrcLog *log = &crcFuzzLogs[order];
+
+    if (log->buf == NULL)
+    {
+        crcLogInit(log, crcFuzzLogBuf[order], sizeof crcFuzzLogBuf[order],
+                   crcFuzzLogRec[order], 8, order);
+    }
+
+    size_t n = (len < 200) ? len : 200;
+    if (order != CRC_ORDER_BYTES)
+    {
+        n &= ~(size_t)3;
+    }
+    crcLogAppend(log, p, n);
+
+    size_t total = 0;
+    for (size_t i = 0; i < log->recCount; i++)
+    {
+        total += crcLogRead(log, i, crcFuzzLogWindow + total);
+    }
+    crcFuzzCheck("crcLogCrc", crcLogCrc(log, init), crcFuzzRef(crcFuzzLogWindow, total, init, order),
+                 0, total, init, order);
+    crcFuzzCheck("crcLogVerify", (uint32_t)crcLogVerify(log), 0, 0, total, init, order);
+}
+
+static uint32_t crcFuzzImageBuf[4096 / 4];
+static uint32_t crcFuzzIndexBuf[sizeof(CrcImageIndex) / 4 + 4096 / 4];
+
+static void crcFuzzImageDone(CrcImageVerify *v, void *arg)
+{
+    (void)v;
+    *(int *)arg = 1;
+}
+
+// crcImageVerifyStart() from sector first, doing the DMA transfers
+static void crcFuzzImageVerify(CrcImageVerify *v, const CrcImageIndex *index, uint32_t first)
+{
+    int done = 0;
+
+    crcImageVerifyStart(v, index, crcFuzzImageBuf, first, crcFuzzImageDone, &done);
+    while (!done)
+    {
+        if (crcSimDmaComplete())
+        {
+            crcDmaIrqHandler();
+        }
+    }
+}
+
+// A random image with its index made from the reference, checked, then
+//  checked again with one byte of one sector changed
+static void crcFuzzImage(void)
+{
+    uint8_t *image = (uint8_t *)crcFuzzImageBuf;
+    CrcImageIndex *index = (CrcImageIndex *)crcFuzzIndexBuf;
+    uint32_t len = 4 * (1 + crcFuzzRand() % (sizeof crcFuzzImageBuf / 4));
+    uint32_t sectorSize = 4 * (1 + crcFuzzRand() % 256);
+
+    for (uint32_t i = 0; i < len; i++)
+    {
+        image[i] = (uint8_t)crcFuzzRand();
+    }
+    index->magic = CRC_IMAGE_MAGIC;
+    index->imageLen = len;
+    index->sectorSize = sectorSize;
+    index->sectorCount = (len + sectorSize - 1) / sectorSize;
+    index->imageCrc = crcFuzzRef(image, len, 0xFFFFFFFFu, CRC_ORDER_WORDS);
+    for (uint32_t i = 0; i < index->sectorCount; i++)
+    {
+        uint32_t n = (len - i * sectorSize < sectorSize) ? len - i * sectorSize : sectorSize;
+        index->sectorCrc[i] = crcFuzzRef(image + i * sectorSize, n, 0xFFFFFFFFu, CRC_ORDER_WORDS);
+    }
+
+    crcFuzzCheck("crcImageCheckIndex", (uint32_t)crcImageCheckIndex(index), 0,
+                 0, len, 0xFFFFFFFFu, CRC_ORDER_WORDS);
+
+    CrcImageVerify v;
+    uint32_t first = crcFuzzRand() % (index->sectorCount + 1);
+    crcFuzzImageVerify(&v, index, first);
+    crcFuzzCheck("crcImageVerifyStart", (uint32_t)v.result, 0, first, len, 0xFFFFFFFFu,
+                 CRC_ORDER_WORDS);
+    crcFuzzCheck("crcImageVerifyStart imageCrc", v.imageCrc, index->imageCrc, first, len,
+                 0xFFFFFFFFu, CRC_ORDER_WORDS);
+
+    // A change of up to 32 bits always changes the CRC
+    uint32_t at = crcFuzzRand() % len;
+    uint32_t bad = at / sectorSize;
+    image[at] ^= (uint8_t)(1 + crcFuzzRand() % 255);
+
+    crcFuzzCheck("crcImageCheckSectors bad", (uint32_t)crcImageCheckSectors(index, image, bad, 1),
+                 (uint32_t)-1, at, len, 0xFFFFFFFFu, CRC_ORDER_WORDS);
+    crcFuzzCheck("crcImageCheckSectors rest",
+                 (uint32_t)crcImageCheckSectors(index, image, bad + 1, index->sectorCount - bad - 1),
+                 0, at, len, 0xFFFFFFFFu, CRC_ORDER_WORDS);
+
+    first = crcFuzzRand() % (bad + 1);
+    crcFuzzImageVerify(&v, index, first);
+    crcFuzzCheck("crcImageVerifyStart bad", (uint32_t)v.result, (uint32_t)-1, at, len, 0xFFFFFFFFu,
+                 CRC_ORDER_WORDS);
+    crcFuzzCheck("crcImageVerifyStart firstBad", (uint32_t)v.firstBad, bad, at, len, 0xFFFFFFFFu,
+                 CRC_ORDER_WORDS);
+    crcFuzzCheck("crcImageVerifyStart bad imageCrc", v.imageCrc,
+                 crcFuzzRef(image, len, 0xFFFFFFFFu, CRC_ORDER_WORDS), at, len, 0xFFFFFFFFu,
+                 CRC_ORDER_WORDS);
+}
+
+// Every parameter set in crc_prog.h, for crcPolyCalc()
+static const CrcParams *const crcFuzzParams[] =
+{
+    &crcParamsCrc32, &crcParamsCrc32Mpeg2, &crcParamsCrc32C, &crcParamsCrc32K,
+    &crcParamsCrc16Ccitt, &crcParamsCrc16Modbus, &crcParamsCrc8Smbus,
+};
+
+#define CRC_FUZZ_PARAMS (sizeof crcFuzzParams / sizeof crcFuzzParams[0])
+
+static CrcPoly crcFuzzPoly[CRC_FUZZ_PARAMS];
+
+// crcPolyCalc(), which uses the peripheral when it can, against the table;
+//  the two that the doc's references cover are checked against them too
+static void crcFuzzPolyCheck(const uint8_t *p, size_t len, size_t offset)
+{
+    if (crcFuzzPoly[0].params.width == 0)
+    {
+        for (size_t i = 0; i < CRC_FUZZ_PARAMS; i++)
+        {
+            crcPolyInit(&crcFuzzPoly[i], crcFuzzParams[i]);
+        }
+    }
+
+    for (size_t i = 0; i < CRC_FUZZ_PARAMS; i++)
+    {
+        const CrcParams *params = crcFuzzParams[i];
+
+        crcFuzzCheck("crcPolyCalc", crcPolyCalc(&crcFuzzPoly[i], p, len),
+                     crcPolySwCalc(&crcFuzzPoly[i], p, len), offset, len, params->init,
+                     CRC_ORDER_BYTES);
+    }
+    crcFuzzCheck("crcPolySwCalc Mpeg2", crcPolySwCalc(&crcFuzzPoly[1], p, len),
+                 crcFuzzRef(p, len, 0xFFFFFFFFu, CRC_ORDER_BYTES), offset, len, 0xFFFFFFFFu,
+                 CRC_ORDER_BYTES);
+    crcFuzzCheck("crcPolySwCalc Crc32", crcPolySwCalc(&crcFuzzPoly[0], p, len),
+                 ~crcFuzzRefReflected(p, len, 0xFFFFFFFFu), offset, len, 0xFFFFFFFFu,
+                 CRC_ORDER_BYTES);
+}
+
+// Tables for crc_select.h: the defaults, the probed ones, and ones that
+//  use every backend in turn, for each order and then reflected
+#define CRC_FUZZ_SELECT_KINDS 3u
+
+static CrcSelect crcFuzzSelects[CRC_FUZZ_SELECT_KINDS][4];
+static int crcFuzzSelectReady;
+
+static void crcFuzzSelectSetup(void)
+{
+    CrcSelect *sel = crcFuzzSelects[0];
+
+    for (int k = 0; k < 4; k++)
+    {
+        if (k < 3)
+        {
+            crcSelectInit(&sel[k], (CrcOrder)k);
+        }
+        else
+        {
+            crcSelectInitReflected(&sel[k]);
+        }
+        crcFuzzSelects[1][k] = sel[k];
+        crcSelectProbe(&crcFuzzSelects[1][k], crcFuzzBuf, CRC_FUZZ_MAX_LEN);
+        crcFuzzSelects[2][k] = sel[k];
+    }
+
+    const CrcSelectStep bytes[] =
+    {
+        { 0, crcBackendSw }, { 4, crcBackendHw }, { 8, crcBackendProg },
+        { 17, crcBackendSw }, { 64, crcBackendProg }, { 255, crcBackendHw },
+    };
+    const CrcSelectStep words[] =
+    {
+        { 0, crcBackendHw }, { 5, crcBackendSw }, { 16, crcBackendHw },
+#if CRC_SELECT_DMA
+        { 64, crcBackendDma }, { 1024, crcBackendSw },
+#else
+        { 64, crcBackendSw },
+#endif
+    };
+    const CrcSelectStep reflected[] =
+    {
+        { 0, crcBackendRbit }, { 3, crcBackendReflectSw }, { 8, crcBackendRbit },
+        { 33, crcBackendReflectSw }, { 256, crcBackendRbit },
+    };
+    crcSelectSet(&crcFuzzSelects[2][CRC_ORDER_BYTES], bytes, sizeof bytes / sizeof bytes[0]);
+    crcSelectSet(&crcFuzzSelects[2][CRC_ORDER_WORDS], words, sizeof words / sizeof words[0]);
+    crcSelectSet(&crcFuzzSelects[2][CRC_ORDER_HALFWORDS], words, sizeof words / sizeof words[0]);
+    crcSelectSet(&crcFuzzSelects[2][3], reflected, sizeof reflected / sizeof reflected[0]);
+    crcFuzzSelectReady = 1;
+}
+
+static uint32_t crcFuzzSelectRef(const CrcSelect *sel, const uint8_t *p, size_t len, uint32_t init)
+{
+    return sel->reflected ? crcFuzzRefReflected(p, len, init) : crcFuzzRef(p, len, init, sel->order);
+}
+
+// crcSelectUpdate() with one of the tables: the whole of the data, the data
+//  in two pieces (which may go to different backends), and lengths either
+//  side of one of the table's thresholds
+static void crcFuzzSelect(const uint8_t *p, size_t len, size_t cut, uint32_t init, CrcOrder order)
+{
+    const uint8_t *buf = (const uint8_t *)crcFuzzBuf;
+
+    // crcBackendDma() waits for its transfer, so the model does it at once
+#if CRC_SELECT_DMA
+    crcSimSetDmaIrq(crcDmaIrqHandler);
+#endif
+    if (!crcFuzzSelectReady)
+    {
+        crcFuzzSelectSetup();
+    }
+
+    int reflected = (crcFuzzRand() % 4 == 0);
+    const CrcSelect *sel = &crcFuzzSelects[crcFuzzRand() % CRC_FUZZ_SELECT_KINDS][reflected ? 3 : order];
+    size_t offset = (size_t)(p - buf);
+    uint32_t want = crcFuzzSelectRef(sel, p, len, init);
+
+    crcFuzzCheck("crcSelectUpdate", crcSelectUpdate(sel, init, p, len), want,
+                 offset, len, init, sel->order);
+    uint32_t crcReg = crcSelectUpdate(sel, init, p, cut);
+    crcFuzzCheck("crcSelectUpdate pieces", crcSelectUpdate(sel, crcReg, p + cut, len - cut), want,
+                 offset, len, init, sel->order);
+
+    // Setting up a table once the part has been probed leaves a CRC in
+    //  progress on the peripheral alone
+    CrcCtx ctx;
+    CrcSelect fresh;
+    crcInit(&ctx, init, order);
+    crcUpdate(&ctx, p, cut);
+    crcSelectInit(&fresh, order);
+    crcUpdate(&ctx, p + cut, len - cut);
+    crcFuzzCheck("crcSelectInit in a stream", crcFinal(&ctx), crcFuzzRef(p, len, init, order),
+                 offset, len, init, order);
+
+    const CrcSelectStep *s = &sel->step[crcFuzzRand() % sel->steps];
+    for (size_t n = s->minLen ? s->minLen - 1 : 0; n <= s->minLen + 1; n++)
+    {
+        if (offset + n <= CRC_FUZZ_MAX_LEN)
+        {
+            crcFuzzCheck("crcSelectUpdate threshold", crcSelectUpdate(sel, init, p, n),
+                         crcFuzzSelectRef(sel, p, n, init), offset, n, init, sel->order);
+        }
+    }
+
+#if CRC_SELECT_DMA
+    crcSimSetDmaIrq(NULL);
+#endif
+}
+
+static void crcFuzzCase(void)
+{
+    uint8_t *buf = (uint8_t *)crcFuzzBuf;
+    size_t offset = crcFuzzRand() % 8;
+    size_t len = crcFuzzLen();
+    uint32_t init = crcFuzzInit();
+    CrcOrder order = (CrcOrder)(crcFuzzRand() % 3);
+    const uint8_t *p = buf + offset;
+
+    for (size_t i = 0; i < offset + len; i++)
+    {
+        buf[i] = (uint8_t)crcFuzzRand();
+    }
+
+    uint32_t want = crcFuzzRef(p, len, init, order);
+
+    crcFuzzCheck("crcCalc", crcCalc(p, len, init, order), want, offset, len, init, order);
+    crcFuzzCheck("crcSwCalc", crcSwCalc(p, len, init, order), want, offset, len, init, order);
+    crcFuzzCheck("crcHostCalc", crcHostCalc(p, len, init, order), want, offset, len, init, order);
+    crcFuzzCheck("crcUpdateDma", crcFuzzDma(p, len, init, order), want, offset, len, init, order);
+    crcFuzzCheck("crcUpdateXip", crcFuzzXip(p, len, init, order), want, offset, len, init, order);
+
+    // crc_prog.c with the basic peripheral's CRC, which the model (like the
+    //  basic peripheral) can only do with 32-bit writes
+    CrcParams basic = { 32, 0, 0, CRC_POLY, init, 0 };
+    crcFuzzCheck("crcProgCalc", crcProgCalc(&basic, p, len), crcFuzzRef(p, len, init, CRC_ORDER_BYTES),
+                 offset, len, init, CRC_ORDER_BYTES);
+    crcFuzzPolyCheck(p, len, offset);
+
+    // "Changing the Initial Value": XORing the initial value into the first
+    //  32 bits fed to simpleCRC() gives the same as starting crcReg with it
+    if (len >= 4)
+    {
+        size_t n = crcFuzzOrdered(crcFuzzTmp, p, len, order);
+        for (int i = 0; i < 4; i++)
+        {
+            crcFuzzTmp[i] ^= (uint8_t)(init >> (24 - 8 * i));
+        }
+        crcFuzzCheck("simpleCRC", simpleCRC(crcFuzzTmp, n), want, offset, len, init, order);
+    }
+
+    // Streaming in pieces, one call per piece or all at once
+    size_t cut[3];
+    size_t cuts = crcFuzzCuts(cut, p, len, order);
+    CrcIovec iov[4];
+    size_t from = 0;
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        size_t to = (i < cuts) ? cut[i] : len;
+        iov[i].base = p + from;
+        iov[i].len = to - from;
+        from = to;
+    }
+
+    CrcCtx ctx;
+    crcInit(&ctx, init, order);
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        crcUpdate(&ctx, iov[i].base, iov[i].len);
+    }
+    crcFuzzCheck("crcUpdate pieces", crcFinal(&ctx), want, offset, len, init, order);
+
+    // The same with the partial-word method picked at random for each piece
+    crcInit(&ctx, init, order);
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        crcSetTail(&ctx, (CrcTail)(crcFuzzRand() % 2));
+        crcUpdate(&ctx, iov[i].base, iov[i].len);
+    }
+    crcFuzzCheck("crcUpdate tails", crcFinal(&ctx), want, offset, len, init, order);
+
+    crcInit(&ctx, init, order);
+    crcUpdateVec(&ctx, iov, cuts + 1);
+    crcFuzzCheck("crcUpdateVec", crcFinal(&ctx), want, offset, len, init, order);
+
+    // The pieces as separate messages in one batch
+    uint32_t batch[4];
+    crcCalcBatch(iov, cuts + 1, init, order, batch);
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        crcFuzzCheck("crcCalcBatch", batch[i], crcFuzzRef(iov[i].base, iov[i].len, init, order),
+                     (size_t)((const uint8_t *)iov[i].base - buf), iov[i].len, init, order);
+    }
+
+    // The pieces as queued jobs, each with its own initial value and order
+    CrcJob job[4];
+    uint32_t jobCrc[4];
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        job[i].data = iov[i].base;
+        job[i].len = iov[i].len;
+        job[i].initValue = crcFuzzInit();
+        job[i].order = (CrcOrder)(crcFuzzRand() % 3);
+        job[i].arg = &jobCrc[i];
+    }
+    crcFuzzQueue(job, cuts + 1);
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        crcFuzzCheck("crcQueueService", jobCrc[i],
+                     crcFuzzRef(iov[i].base, iov[i].len, job[i].initValue, job[i].order),
+                     (size_t)((const uint8_t *)iov[i].base - buf), iov[i].len, job[i].initValue,
+                     job[i].order);
+    }
+
+    // The same jobs batched by crc_lowpower.c, the model doing each
+    //  transfer at once as crcLpWait() spins on the host.  The deadlines
+    //  are all after tick 0, so crcLpPoll(0) holds them unless there is a
+    //  batch's worth of data.
+    crcSimSetDmaIrq(crcDmaIrqHandler);
+    crcFuzzJobsDone = 0;
+    crcFuzzLpFollow = job[0];
+    crcFuzzLpFollow.done = crcFuzzJobDone;
+    crcFuzzLpFollow.arg = &crcFuzzLpFollowCrc;
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        job[i].done = i ? crcFuzzJobDone : crcFuzzLpDoneFirst;
+        jobCrc[i] = ~jobCrc[i];
+        crcLpPost(&job[i], 1 + crcFuzzRand() % 0x7FFFFFFFu);
+    }
+    crcLpPoll(0);
+    if (len < CRC_LP_BATCH_BYTES)
+    {
+        crcFuzzCheck("crcLpPoll held", (uint32_t)crcFuzzJobsDone + crcLpPending(),
+                     (uint32_t)cuts + 1, offset, len, init, order);
+    }
+    crcLpFlush();
+    crcLpFlush();
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        crcFuzzCheck("crcLpFlush", jobCrc[i],
+                     crcFuzzRef(iov[i].base, iov[i].len, job[i].initValue, job[i].order),
+                     (size_t)((const uint8_t *)iov[i].base - buf), iov[i].len, job[i].initValue,
+                     job[i].order);
+    }
+    crcFuzzCheck("crcLpFlush followed", crcFuzzLpFollowCrc, jobCrc[0], offset, iov[0].len,
+                 job[0].initValue, job[0].order);
+    crcFuzzCheck("crcLpFlush jobs", (uint32_t)crcFuzzJobsDone, (uint32_t)cuts + 2, offset, len,
+                 init, order);
+    crcFuzzCheck("crcLpFlush clock", (uint32_t)crcFuzzClockOn + crcLpPending(), 0, offset, len,
+                 init, order);
+    crcSimSetDmaIrq(NULL);
+
+    // Two shared streams taking turns on the peripheral: the pieces of this
+    //  one, and the same pieces in reverse order in another stream
+    CrcCtx other;
+    CrcOrder otherOrder = (order == CRC_ORDER_BYTES) ? CRC_ORDER_BYTES : CRC_ORDER_WORDS;
+    uint32_t otherInit = ~init;
+    crcSharedInit(&ctx, init, order);
+    crcSharedInit(&other, otherInit, otherOrder);
+    crcSetTail(&other, CRC_TAIL_TABLE);
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        crcSharedUpdate(&ctx, iov[i].base, iov[i].len);
+        crcSharedUpdate(&other, iov[cuts - i].base, iov[cuts - i].len);
+    }
+    uint32_t otherCrc = crcSharedFinal(&other);
+    crcFuzzCheck("crcShared", crcSharedFinal(&ctx), want, offset, len, init, order);
+    uint32_t otherWant = otherInit;
+    for (size_t i = cuts + 1; i > 0; i--)
+    {
+        size_t n = crcFuzzOrdered(crcFuzzTmp, iov[i - 1].base, iov[i - 1].len, otherOrder);
+        otherWant = cleverCRC(otherWant, crcFuzzTmp, n);
+    }
+    crcFuzzCheck("crcShared other", otherCrc, otherWant, offset, len, otherInit, otherOrder);
+
+    // Joining the CRCs of two pieces, and shifting by zero bytes
+    size_t k = cuts ? cut[0] : 0;
+    uint32_t crcA = crcCalc(p, k, init, order);
+    uint32_t crcB = crcSwCalc(p + k, len - k, 0xFFFFFFFFu, order);
+    crcFuzzCheck("crc32Combine", crc32Combine(crcA, crcB, len - k), want, offset, len, init, order);
+
+    CrcStripe stripe[4];
+    unsigned engines = 1 + crcFuzzRand() % 4;
+    for (unsigned i = 0; i < engines; i++)
+    {
+        stripe[i].weight = crcFuzzRand() % 4;
+    }
+    crcFuzzCheck("crcStripeCalc", crcStripeCalc(stripe, engines, p, len, init, order), want,
+                 offset, len, init, order);
+
+    crcFuzzCheck("crcStripeCalcSw", crcStripeCalcSw(p, len, init, order), want,
+                 offset, len, init, order);
+
+    // The pieces as separate streams, each with its own initial value
+    CrcSwStream streams[4];
+    uint32_t streamInit[4];
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        streamInit[i] = crcFuzzInit();
+        streams[i].data = iov[i].base;
+        streams[i].len = iov[i].len;
+        streams[i].crcReg = streamInit[i];
+    }
+    crcSwUpdateStreams(streams, (unsigned)cuts + 1, order);
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        crcFuzzCheck("crcSwUpdateStreams", streams[i].crcReg,
+                     crcFuzzRef(iov[i].base, iov[i].len, streamInit[i], order),
+                     (size_t)((const uint8_t *)iov[i].base - buf), iov[i].len, streamInit[i], order);
+    }
+
+    size_t zeros = crcFuzzRand() % 64;
+    memset(crcFuzzTmp, 0, zeros);
+    crcFuzzCheck("crcShift", crcShift(init, zeros), cleverCRC(init, crcFuzzTmp, zeros),
+                 0, zeros, init, CRC_ORDER_BYTES);
+
+    // Patching a few bytes of an aligned buffer
+    size_t total = (order == CRC_ORDER_BYTES) ? offset + len : (offset + len) & ~(size_t)3;
+    if (total)
+    {
+        uint32_t before = crcFuzzRef(buf, total, init, order);
+        size_t at = crcFuzzRand() % total;
+        size_t n = 1 + crcFuzzRand() % 16;
+        uint8_t old[16];
+        if (n > total - at)
+        {
+            n = total - at;
+        }
+        memcpy(old, buf + at, n);
+        for (size_t i = 0; i < n; i++)
+        {
+            buf[at + i] = (uint8_t)crcFuzzRand();
+        }
+        crcFuzzCheck("crcPatch", crcPatch(before, at, old, buf + at, n, total, order),
+                     crcFuzzRef(buf, total, init, order), at, total, init, order);
+    }
+
+    // "Reversing Bit Order"
+    crcFuzzCheck("crc32Zlib", crc32Zlib(p, len), ~crcFuzzRefReflected(p, len, 0xFFFFFFFFu),
+                 offset, len, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+    crcInitReflected(&ctx, init);
+    for (size_t i = 0; i <= cuts; i++)
+    {
+        crcUpdateReflected(&ctx, iov[i].base, iov[i].len);
+    }
+    crcFuzzCheck("crcUpdateReflected", crcFinalReflected(&ctx), crcFuzzRefReflected(p, len, init),
+                 offset, len, init, CRC_ORDER_BYTES);
+
+    crcFuzzSelect(p, len, k, init, order);
+    crcFuzzLog(p, len, init, order);
+    if (crcFuzzRand() % 8 == 0)
+    {
+        crcFuzzImage();
+    }
+}
+
+// The examples worked through in stm32crc.adoc
+static void crcFuzzDocVectors(void)
+{
+    static const uint8_t data[11] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0xA6, 0xB7, 0xC8 };
+    uint8_t *buf = (uint8_t *)crcFuzzBuf;
+
+    // "End Address": the data at a word boundary, initial value 0xFFFFFFFF
+    memcpy(buf, data, sizeof data);
+    crcFuzzCheck("doc end cleverCRC", cleverCRC(0xFFFFFFFFu, data, 11), 0xF7832A2Fu,
+                 0, 11, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+    crcFuzzCheck("doc end 8 bytes", cleverCRC(0xFFFFFFFFu, data, 8), 0x7D24A31Bu,
+                 0, 8, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+    crcFuzzCheck("doc end crcCalc", crcCalc(buf, 11, 0xFFFFFFFFu, CRC_ORDER_BYTES), 0xF7832A2Fu,
+                 0, 11, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+    crcFuzzCheck("doc end crcSwCalc", crcSwCalc(buf, 11, 0xFFFFFFFFu, CRC_ORDER_BYTES), 0xF7832A2Fu,
+                 0, 11, 0xFFFFFFFFu, CRC_ORDER_BYTES);
+
+    // "Start Address": the data at 0x0101, initial value 0x55443322, done
+    //  on the model step by step as the doc says.  The doc's initial value
+    //  applies at the word boundary before the data, so the library's
+    //  equivalent is that value shifted past the one byte before 0x0101.
+    static const uint8_t padded[12] = { 0x00, 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0xA6, 0xB7, 0xC8 };
+    memcpy(buf + 1, data, sizeof data);
+    CRC_HW_RESET();
+    CRC_HW_WRITE(0xFFFFFFFFu);
+    CRC_HW_WRITE(0x00123456u ^ 0x55443322u);
+    CRC_HW_WRITE(crcRev(crcFuzzBuf[1]));
+    CRC_HW_WRITE(crcRev(crcFuzzBuf[2]));
+    uint32_t doc = CRC_HW_READ();
+
+    crcFuzzCheck("doc start cleverCRC", doc, cleverCRC(0x55443322u, padded, 12),
+                 1, 11, 0x55443322u, CRC_ORDER_BYTES);
+    crcFuzzCheck("doc start crcCalc", crcCalc(buf + 1, 11, crcShift(0x55443322u, 1), CRC_ORDER_BYTES),
+                 doc, 1, 11, 0x55443322u, CRC_ORDER_BYTES);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long cases = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000000ul;
+    if (argc > 2)
+    {
+        crcFuzzState ^= strtoull(argv[2], NULL, 0);
+    }
+
+    crcFuzzDocVectors();
+    for (unsigned long i = 0; i < cases; i++)
+    {
+        crcFuzzCase();
+    }
+
+    printf("%lu cases, %lu checks, %lu failures\n", cases, crcFuzzChecks, crcFuzzFails);
+    return crcFuzzFails ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+// crc_host.c
+//
+// See crc_host.h.
+//
+// The data is treated as one big polynomial, first bit highest.  Folding
+// replaces a 128-bit block A at distance D bits from the end of the data by
+// A_hi * (x^(D+64) mod P) + A_lo * (x^D mod P), which leaves the CRC
+// unchanged.  Four 128-bit accumulators are folded forward 512 bits at a
+// time, then folded into one, and the last 128 bits go through the table
+// code starting from crcReg = 0.  The starting crcReg is XORed into the
+// first 32 bits, as in "Changing the Initial Value".
+
+#include "crc_host.h"
+#include "crc_sw.h"
+
+// x^n mod P for the fold distances
+#define CRC_K128 0xE8A45605u
+#define CRC_K192 0xC5B9CD4Cu
+#define CRC_K512 0xE6228B11u
+#define CRC_K576 0x8833794Cu
+
+// Where each byte of a 16-byte block goes so that the first bit to be
+//  processed ends up in bit 127
+static const uint8_t crcShufBytes[16] = { 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 };
+static const uint8_t crcShufWords[16] = { 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3 };
+static const uint8_t crcShufHalfwords[16] = { 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1 };
+
+static const uint8_t *crcShufFor(CrcOrder order)
+{
+    switch (order)
+    {
+    case CRC_ORDER_BYTES:
+        return crcShufBytes;
+    case CRC_ORDER_HALFWORDS:
+        return crcShufHalfwords;
+    default:
+        return crcShufWords;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define CRC_HOST_CLMUL 1
+#define CRC_HOST_TARGET __attribute__((target("pclmul,ssse3")))
+
+CRC_HOST_TARGET static inline __m128i crcFold(__m128i a, __m128i k)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(a, k, 0x11), _mm_clmulepi64_si128(a, k, 0x00));
+}
+
+CRC_HOST_TARGET static inline __m128i crcLoad(const uint8_t *p, __m128i shuf)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p), shuf);
+}
+
+// len is a multiple of 64, and at least 64
+CRC_HOST_TARGET static uint32_t crcClmul(uint32_t crcReg, const uint8_t *p, size_t len, CrcOrder order)
+{
+    const __m128i shuf = _mm_loadu_si128((const __m128i *)crcShufFor(order));
+    const __m128i k512 = _mm_set_epi64x(CRC_K576, CRC_K512);
+    const __m128i k128 = _mm_set_epi64x(CRC_K192, CRC_K128);
+
+    __m128i a0 = crcLoad(p, shuf);
+    __m128i a1 = crcLoad(p + 16, shuf);
+    __m128i a2 = crcLoad(p + 32, shuf);
+    __m128i a3 = crcLoad(p + 48, shuf);
+
+    a0 = _mm_xor_si128(a0, _mm_set_epi32((int)crcReg, 0, 0, 0));
+
+    for (p += 64, len -= 64; len >= 64; p += 64, len -= 64)
+    {
+        a0 = _mm_xor_si128(crcFold(a0, k512), crcLoad(p, shuf));
+        a1 = _mm_xor_si128(crcFold(a1, k512), crcLoad(p + 16, shuf));
+        a2 = _mm_xor_si128(crcFold(a2, k512), crcLoad(p + 32, shuf));
+        a3 = _mm_xor_si128(crcFold(a3, k512), crcLoad(p + 48, shuf));
+    }
+
+    a1 = _mm_xor_si128(crcFold(a0, k128), a1);
+    a2 = _mm_xor_si128(crcFold(a1, k128), a2);
+    a3 = _mm_xor_si128(crcFold(a2, k128), a3);
+
+    uint8_t last[16];
+    _mm_storeu_si128((__m128i *)last, _mm_shuffle_epi8(a3, _mm_loadu_si128((const __m128i *)crcShufBytes)));
+    return crcSwUpdate(0, last, 16, CRC_ORDER_BYTES);
+}
+
+int crcHostAccelerated(void)
+{
+    static int supported = -1;
+
+    if (supported < 0)
+    {
+        __builtin_cpu_init();
+        supported = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+    }
+    return supported;
+}
+
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+
+#include <arm_neon.h>
+
+#define CRC_HOST_CLMUL 1
+
+static inline uint64x2_t crcFold(uint64x2_t a, poly64_t kHi, poly64_t kLo)
+{
+    poly128_t hi = vmull_p64((poly64_t)vgetq_lane_u64(a, 1), kHi);
+    poly128_t lo = vmull_p64((poly64_t)vgetq_lane_u64(a, 0), kLo);
+    return veorq_u64(vreinterpretq_u64_p128(hi), vreinterpretq_u64_p128(lo));
+}
+
+static inline uint64x2_t crcLoad(const uint8_t *p, uint8x16_t shuf)
+{
+    return vreinterpretq_u64_u8(vqtbl1q_u8(vld1q_u8(p), shuf));
+}
+
+// len is a multiple of 64, and at least 64
+static uint32_t crcClmul(uint32_t crcReg, const uint8_t *p, size_t len, CrcOrder order)
+{
+    const uint8x16_t shuf = vld1q_u8(crcShufFor(order));
+
+    uint64x2_t a0 = crcLoad(p, shuf);
+    uint64x2_t a1 = crcLoad(p + 16, shuf);
+    uint64x2_t a2 = crcLoad(p + 32, shuf);
+    uint64x2_t a3 = crcLoad(p + 48, shuf);
+
+    a0 = veorq_u64(a0, vcombine_u64(vcreate_u64(0), vcreate_u64((uint64_t)crcReg << 32)));
+
+    for (p += 64, len -= 64; len >= 64; p += 64, len -= 64)
+    {
+        a0 = veorq_u64(crcFold(a0, CRC_K576, CRC_K512), crcLoad(p, shuf));
+        a1 = veorq_u64(crcFold(a1, CRC_K576, CRC_K512), crcLoad(p + 16, shuf));
+        a2 = veorq_u64(crcFold(a2, CRC_K576, CRC_K512), crcLoad(p + 32, shuf));
+        a3 = veorq_u64(crcFold(a3, CRC_K576, CRC_K512), crcLoad(p + 48, shuf));
+    }
+
+    a1 = veorq_u64(crcFold(a0, CRC_K192, CRC_K128), a1);
+    a2 = veorq_u64(crcFold(a1, CRC_K192, CRC_K128), a2);
+    a3 = veorq_u64(crcFold(a2, CRC_K192, CRC_K128), a3);
+
+    uint8_t last[16];
+    vst1q_u8(last, vqtbl1q_u8(vreinterpretq_u8_u64(a3), vld1q_u8(crcShufBytes)));
+    return crcSwUpdate(0, last, 16, CRC_ORDER_BYTES);
+}
+
+int crcHostAccelerated(void)
+{
+    return 1;
+}
+
+#else
+
+#define CRC_HOST_CLMUL 0
+
+int crcHostAccelerated(void)
+{
+    return 0;
+}
+
+#endif
+
+uint32_t crcHostUpdate(uint32_t crcReg, const void *data, size_t len, CrcOrder order)
+{
+#if CRC_HOST_CLMUL
+    const uint8_t *p = data;
+    size_t head = (0u - (uintptr_t)p) & 3u;
+
+    if (len >= head + 64 && crcHostAccelerated())
+    {
+        // Split on word boundaries, so partial words are
+        //  handled by the table code exactly as on the target
+        size_t bulk = (len - head) & ~(size_t)63;
+
+        crcReg = crcSwUpdate(crcReg, p, head, order);
+        crcReg = crcClmul(crcReg, p + head, bulk, order);
+        return crcSwUpdate(crcReg, p + head + bulk, len - head - bulk, order);
+    }
+#endif
+    return crcSwUpdate(crcReg, data, len, order);
+}
+
+uint32_t crcHostCalc(const void *data, size_t len, uint32_t initValue, CrcOrder order)
+{
+    return crcHostUpdate(initValue, data, len, order);
+}
@@ -0,0 +1,40 @@
+// crc_host.h
+//
+// Fast CRC calculation on build servers and test stations, giving exactly
+// the same results as the STM32 peripheral code in src/ (most-significant
+// bit first, polynomial 0x04C11DB7, any CrcOrder).
+//
+// Uses carry-less multiplication to fold 64 bytes at a time: PCLMULQDQ on
+// x86-64 (detected at run time), or PMULL on ARMv8 when built with the
+// crypto extension.  The re-ordering from "Quickly Re-ordering Bytes" is done
+// with a byte shuffle as the data is loaded.  Without either instruction it
+// falls back to the table-driven crc_sw.c.
+//
+// Build with -Isrc, and link src/crc_sw.c and src/crc_sw_tables.c.
+
+#ifndef CRC_HOST_H
+#define CRC_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Continue a CRC from crcReg over len bytes; same results as crcSwUpdate()
+uint32_t crcHostUpdate(uint32_t crcReg, const void *data, size_t len, CrcOrder order);
+
+// One-shot, with the given initial value
+uint32_t crcHostCalc(const void *data, size_t len, uint32_t initValue, CrcOrder order);
+
+// Non-zero if carry-less multiply is being used
+int crcHostAccelerated(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_HOST_H
@@ -0,0 +1,312 @@
+// crc_par.c
+//
+// See crc_par.h.
+//
+// The calling thread hands each job to the pool by bumping a generation
+// count, then takes chunks itself along with the workers; chunks are handed
+// out by an atomic counter, so a thread that gets slow chunks (pages not yet
+// in the cache) just takes fewer.  Every worker joins in every job, which
+// keeps the hand-over to one mutex and two condition variables.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "crc_par.h"
+#include "crc_combine.h"
+#include "crc_host.h"
+
+static struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t start;       // a new job, or stopping
+    pthread_cond_t finished;    // the last worker is done with the job
+    pthread_t thread[CRC_PAR_THREADS_MAX];
+    unsigned workers;
+    unsigned generation;
+    unsigned busy;              // workers still on the current job
+    int stopping;
+
+    // The current job
+    const uint8_t *data;
+    size_t len;
+    uint32_t initValue;
+    CrcParMode mode;
+    uint32_t *crc;              // each chunk's CRC
+    size_t skew;                // data's offset from a chunk boundary
+    size_t chunks;
+    size_t next;                // the next chunk to take
+} crcPar =
+{
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .start = PTHREAD_COND_INITIALIZER,
+    .finished = PTHREAD_COND_INITIALIZER,
+};
+
+static uint32_t crcParTable[4][256];
+static int crcParTableReady;
+
+static void crcParTables(void)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+
+        for (int bit = 0; bit < 8; bit++)
+        {
+            c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1u)));
+        }
+        crcParTable[0][i] = c;
+    }
+    for (int k = 1; k < 4; k++)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = crcParTable[k - 1][i];
+
+            crcParTable[k][i] = (c >> 8) ^ crcParTable[0][c & 0xFFu];
+        }
+    }
+    crcParTableReady = 1;
+}
+
+// The reflected CRC-32, slice-by-4
+static uint32_t crcParReflected(uint32_t crcReg, const uint8_t *p, size_t len)
+{
+    for (; len && ((uintptr_t)p & 3u); len--)
+    {
+        crcReg = (crcReg >> 8) ^ crcParTable[0][(crcReg ^ *p++) & 0xFFu];
+    }
+    for (; len >= 4; p += 4, len -= 4)
+    {
+        crcReg ^= (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+        crcReg = crcParTable[3][crcReg & 0xFFu] ^ crcParTable[2][(crcReg >> 8) & 0xFFu] ^
+                 crcParTable[1][(crcReg >> 16) & 0xFFu] ^ crcParTable[0][crcReg >> 24];
+    }
+    for (; len; len--)
+    {
+        crcReg = (crcReg >> 8) ^ crcParTable[0][(crcReg ^ *p++) & 0xFFu];
+    }
+    return crcReg;
+}
+
+static uint32_t crcParRbit(uint32_t x)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+static uint32_t crcParChunk(const uint8_t *p, size_t len, uint32_t crcReg, CrcParMode mode)
+{
+    if (mode == CRC_PAR_REFLECTED)
+    {
+        return crcParReflected(crcReg, p, len);
+    }
+    return crcHostUpdate(crcReg, p, len, (CrcOrder)mode);
+}
+
+static void crcParWork(void)
+{
+    for (;;)
+    {
+        size_t i = __atomic_fetch_add(&crcPar.next, 1, __ATOMIC_RELAXED);
+        if (i >= crcPar.chunks)
+        {
+            return;
+        }
+
+        size_t from = i ? i * CRC_PAR_CHUNK - crcPar.skew : 0;
+        size_t to = (i + 1) * CRC_PAR_CHUNK - crcPar.skew;
+        if (to > crcPar.len)
+        {
+            to = crcPar.len;
+        }
+        crcPar.crc[i] = crcParChunk(crcPar.data + from, to - from, i ? 0 : crcPar.initValue,
+                                    crcPar.mode);
+    }
+}
+
+// arg is the generation when the thread was made, as a job may be handed
+//  out before the thread first runs
+static void *crcParWorker(void *arg)
+{
+    unsigned seen = (unsigned)(uintptr_t)arg;
+
+    pthread_mutex_lock(&crcPar.lock);
+    for (;;)
+    {
+        while (crcPar.generation == seen && !crcPar.stopping)
+        {
+            pthread_cond_wait(&crcPar.start, &crcPar.lock);
+        }
+        if (crcPar.stopping)
+        {
+            break;
+        }
+        seen = crcPar.generation;
+        pthread_mutex_unlock(&crcPar.lock);
+
+        crcParWork();
+
+        pthread_mutex_lock(&crcPar.lock);
+        if (--crcPar.busy == 0)
+        {
+            pthread_cond_signal(&crcPar.finished);
+        }
+    }
+    pthread_mutex_unlock(&crcPar.lock);
+    return NULL;
+}
+
+int crcParStart(unsigned threads)
+{
+    crcParStop();
+
+    if (threads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (cpus > 0) ? (unsigned)cpus : 1;
+    }
+    if (threads > CRC_PAR_THREADS_MAX)
+    {
+        threads = CRC_PAR_THREADS_MAX;
+    }
+
+    for (unsigned i = 0; i + 1 < threads; i++)
+    {
+        if (pthread_create(&crcPar.thread[i], NULL, crcParWorker,
+                           (void *)(uintptr_t)crcPar.generation) != 0)
+        {
+            crcParStop();
+            return -1;
+        }
+        crcPar.workers++;
+    }
+    return 0;
+}
+
+void crcParStop(void)
+{
+    pthread_mutex_lock(&crcPar.lock);
+    crcPar.stopping = 1;
+    pthread_cond_broadcast(&crcPar.start);
+    pthread_mutex_unlock(&crcPar.lock);
+
+    for (unsigned i = 0; i < crcPar.workers; i++)
+    {
+        pthread_join(crcPar.thread[i], NULL);
+    }
+    crcPar.workers = 0;
+    crcPar.stopping = 0;
+}
+
+uint32_t crcParCalc(const void *data, size_t len, uint32_t initValue, CrcParMode mode)
+{
+    size_t skew = (uintptr_t)data % CRC_PAR_CHUNK;
+    size_t chunks = (skew + len + CRC_PAR_CHUNK - 1) / CRC_PAR_CHUNK;
+    uint32_t *crc = NULL;
+
+    if (mode == CRC_PAR_REFLECTED && !crcParTableReady)
+    {
+        crcParTables();
+    }
+    if (crcPar.workers == 0 || chunks < 2 || (crc = malloc(chunks * sizeof *crc)) == NULL)
+    {
+        return crcParChunk(data, len, initValue, mode);
+    }
+
+    pthread_mutex_lock(&crcPar.lock);
+    crcPar.data = data;
+    crcPar.len = len;
+    crcPar.initValue = initValue;
+    crcPar.mode = mode;
+    crcPar.crc = crc;
+    crcPar.skew = skew;
+    crcPar.chunks = chunks;
+    crcPar.next = 0;
+    crcPar.busy = crcPar.workers;
+    crcPar.generation++;
+    pthread_cond_broadcast(&crcPar.start);
+    pthread_mutex_unlock(&crcPar.lock);
+
+    crcParWork();
+
+    pthread_mutex_lock(&crcPar.lock);
+    while (crcPar.busy)
+    {
+        pthread_cond_wait(&crcPar.finished, &crcPar.lock);
+    }
+    pthread_mutex_unlock(&crcPar.lock);
+
+    // Join the chunks, all but the first and last CRC_PAR_CHUNK bytes
+    //  long.  A reflected CRC bit-reversed is the peripheral's CRC of the
+    //  data with each byte bit-reversed, and zero bytes are the same either
+    //  way, so the reflected chunks can be joined the same way.
+    int reflected = (mode == CRC_PAR_REFLECTED);
+    uint32_t factor = crcShiftFactor(CRC_PAR_CHUNK);
+    uint32_t result = reflected ? crcParRbit(crc[0]) : crc[0];
+    for (size_t i = 1; i < chunks; i++)
+    {
+        uint32_t c = reflected ? crcParRbit(crc[i]) : crc[i];
+
+        if (i + 1 < chunks)
+        {
+            result = crcMulMod(result, factor) ^ c;
+        }
+        else
+        {
+            result = crcShift(result, skew + len - i * CRC_PAR_CHUNK) ^ c;
+        }
+    }
+    free(crc);
+    return reflected ? crcParRbit(result) : result;
+}
+
+int crcParFile(const char *path, uint32_t initValue, CrcParMode mode, uint32_t *crc)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+    if (fstat(fd, &st) < 0)
+    {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+    if (st.st_size == 0)
+    {
+        close(fd);
+        *crc = crcParCalc("", 0, initValue, mode);
+        return 0;
+    }
+
+    size_t len = (size_t)st.st_size;
+    void *map = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        errno = err;
+        return -1;
+    }
+
+    // The chunks are taken roughly from the front, so read ahead
+    posix_madvise(map, len, POSIX_MADV_SEQUENTIAL);
+    *crc = crcParCalc(map, len, initValue, mode);
+    munmap(map, len);
+    return 0;
+}
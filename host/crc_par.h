@@ -0,0 +1,78 @@
+// crc_par.h
+//
+// CRCs of large files on many cores, for checking firmware images and logs
+// on test stations and servers.  The data is split into CRC_PAR_CHUNK-byte
+// chunks, which a pool of threads take in turn; each chunk's CRC is
+// calculated with crcHostUpdate() (carry-less multiply where available)
+// from a zero initial value, and the chunks are joined with the combine
+// operator from crc_combine.h.  Files are mapped into memory with mmap(),
+// so the data is read straight from the page cache with no copy.
+//
+// The peripheral's CRC works in any CrcOrder, as for crcCalc().  Chunks
+// start at addresses that are multiples of CRC_PAR_CHUNK, so for the word
+// orders they fall on word boundaries whatever the data's alignment.
+// CRC_PAR_REFLECTED gives the bit-reflected CRC-32 of crc_reflect.h, by a
+// slice-by-4 table; it is joined by bit-reversing the chunk CRCs, as
+// feeding zeros is the same either way round.
+//
+// Needs POSIX threads and mmap().  Only one thread at a time may call the
+// functions here.  Build with -Isrc and -pthread, and link host/crc_host.c,
+// src/crc_combine.c, src/crc_sw.c and src/crc_sw_tables.c.
+
+#ifndef CRC_PAR_H
+#define CRC_PAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bytes per chunk: big enough that joining is negligible, small enough to
+//  share out evenly
+#ifndef CRC_PAR_CHUNK
+#define CRC_PAR_CHUNK (1024u * 1024u)
+#endif
+
+#ifndef CRC_PAR_THREADS_MAX
+#define CRC_PAR_THREADS_MAX 256u
+#endif
+
+#if CRC_PAR_CHUNK % 64 != 0
+#error "CRC_PAR_CHUNK must be a multiple of 64"
+#endif
+
+// Which CRC: the peripheral's in one of the CrcOrders, or reflected
+typedef enum
+{
+    CRC_PAR_BYTES = CRC_ORDER_BYTES,
+    CRC_PAR_WORDS = CRC_ORDER_WORDS,
+    CRC_PAR_HALFWORDS = CRC_ORDER_HALFWORDS,
+    CRC_PAR_REFLECTED
+} CrcParMode;
+
+// Start the pool, with threads threads in all counting the caller (0 for
+//  one per online CPU).  Returns 0, or -1 if the threads couldn't be made.
+//  Without it, everything runs on the calling thread.
+int crcParStart(unsigned threads);
+
+// Stop the pool's threads
+void crcParStop(void);
+
+// The CRC of len bytes of data from initValue, as crcCalc() would give, or
+//  for CRC_PAR_REFLECTED, the reflected shift register as from
+//  crcFinalReflected() (XOR with 0xFFFFFFFF for zlib)
+uint32_t crcParCalc(const void *data, size_t len, uint32_t initValue, CrcParMode mode);
+
+// The same for a whole file.  Returns 0, or -1 (with errno set) if it
+//  couldn't be opened or mapped.
+int crcParFile(const char *path, uint32_t initValue, CrcParMode mode, uint32_t *crc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_PAR_H
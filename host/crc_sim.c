@@ -0,0 +1,97 @@
+// crc_sim.c
+//
+// See crc_sim.h
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <time.h>
+
+#include "crc_sim.h"
+#include "crc_dma.h"
+
+#define CRC_SIM_POLY 0x04C11DB7u
+
+uint32_t crcSimDR = 0xFFFFFFFFu;        // the value after power-on
+CrcSimStats crcSimStats;
+uint32_t crcSimTable[4][256];
+int crcSimReady;
+
+static void (*crcSimDmaIrq)(void);
+static const uint32_t *crcSimDmaSrc;
+static size_t crcSimDmaWords;
+static int crcSimDmaPending;
+
+// Table k entry i is the change to crcReg from feeding the byte i, then k
+//  zero bytes, from crcReg = 0
+void crcSimSetup(void)
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t r = i << 24;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            r = (r & 0x80000000u) ? (r << 1) ^ CRC_SIM_POLY : r << 1;
+        }
+        crcSimTable[0][i] = r;
+    }
+    for (int k = 1; k < 4; k++)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t r = crcSimTable[k - 1][i];
+            crcSimTable[k][i] = (r << 8) ^ crcSimTable[0][r >> 24];
+        }
+    }
+    crcSimReady = 1;
+}
+
+void crcSimSetDmaIrq(void (*irq)(void))
+{
+    crcSimDmaIrq = irq;
+}
+
+static void crcSimDmaRun(void)
+{
+    for (size_t i = 0; i < crcSimDmaWords; i++)
+    {
+        crcSimWrite(crcSimDmaSrc[i]);
+    }
+    crcSimStats.dmaTransfers++;
+    crcSimStats.dmaWords += crcSimDmaWords;
+}
+
+void crcPortDmaStart(const uint32_t *src, volatile uint32_t *dst, size_t words)
+{
+    (void)dst;                          // always the data register
+
+    crcSimDmaSrc = src;
+    crcSimDmaWords = words;
+    if (crcSimDmaIrq)
+    {
+        crcSimDmaRun();
+        crcSimDmaIrq();
+    }
+    else
+    {
+        crcSimDmaPending = 1;
+    }
+}
+
+int crcSimDmaComplete(void)
+{
+    if (!crcSimDmaPending)
+    {
+        return 0;
+    }
+    crcSimDmaPending = 0;
+    crcSimDmaRun();
+    return 1;
+}
+
+uint32_t crcSimCycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
@@ -0,0 +1,109 @@
+// crc_sim.h
+//
+// A model of the basic CRC peripheral, for running the firmware code in
+// src/ on a PC (e.g. in CI) and benchmarking it on large workloads: build
+// with -DCRC_PORT_HEADER='"crc_sim.h"' -Ihost and link host/crc_sim.c.
+//
+// The data register resets to 0xFFFFFFFF and takes 32-bit words, most-
+// significant bit first, like the hardware.  Each write is four slice-by-4
+// table lookups instead of 32 shifts, so the model runs at host speed.  The
+// tables are built from the polynomial on first use, not shared with
+// crc_sw.c.
+//
+// crcPortDmaStart() is provided: a transfer is done either at once, calling
+// the handler given to crcSimSetDmaIrq() (normally crcDmaIrqHandler) as the
+// transfer-complete interrupt, or, with no handler set, when
+// crcSimDmaComplete() is called.  INIT and POL read as zero and ignore
+// writes, as on the basic peripheral, so crcDetect() finds no extra
+// features and crc_prog.c and crc_poly.c take their fallbacks.
+
+#ifndef CRC_SIM_H
+#define CRC_SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Peripheral accesses since the counters were last cleared
+typedef struct
+{
+    unsigned long writes;
+    unsigned long reads;
+    unsigned long resets;
+    unsigned long dmaTransfers;
+    unsigned long dmaWords;
+} CrcSimStats;
+
+extern uint32_t crcSimDR;
+extern CrcSimStats crcSimStats;
+extern uint32_t crcSimTable[4][256];
+extern int crcSimReady;
+
+void crcSimSetup(void);
+
+static inline void crcSimReset(void)
+{
+    crcSimDR = 0xFFFFFFFFu;
+    crcSimStats.resets++;
+}
+
+static inline void crcSimWrite(uint32_t word)
+{
+    if (!crcSimReady)
+    {
+        crcSimSetup();
+    }
+
+    uint32_t x = crcSimDR ^ word;
+    crcSimDR = crcSimTable[3][x >> 24]
+             ^ crcSimTable[2][(x >> 16) & 0xFFu]
+             ^ crcSimTable[1][(x >> 8) & 0xFFu]
+             ^ crcSimTable[0][x & 0xFFu];
+    crcSimStats.writes++;
+}
+
+static inline uint32_t crcSimRead(void)
+{
+    crcSimStats.reads++;
+    return crcSimDR;
+}
+
+#define CRC_HW_RESET()   crcSimReset()
+#define CRC_HW_WRITE(w)  crcSimWrite(w)
+#define CRC_HW_READ()    crcSimRead()
+#define CRC_HW_DR_ADDR   ((volatile uint32_t *)&crcSimDR)
+
+// The basic peripheral's other registers: CR bit 0 resets the unit and
+//  reads back as zero; INIT and POL are reserved
+#define CRC_HW_SET_CR(v)    ((v) & 1u ? crcSimReset() : (void)0)
+#define CRC_HW_GET_CR()     0u
+#define CRC_HW_SET_INIT(v)  ((void)(v))
+#define CRC_HW_GET_INIT()   0u
+#define CRC_HW_SET_POL(v)   ((void)(v))
+#define CRC_HW_GET_POL()    0u
+#define CRC_HW_WRITE8(b)    crcSimWrite((uint8_t)(b))
+#define CRC_HW_WRITE16(h)   crcSimWrite((uint16_t)(h))
+
+// With a handler, DMA transfers finish inside crcPortDmaStart() and call
+//  it; with NULL (the default), they wait for crcSimDmaComplete()
+void crcSimSetDmaIrq(void (*irq)(void));
+
+// Do the DMA transfer waiting to be done, if any.  Returns 1 if there was
+//  one, after which the caller should call crcDmaIrqHandler(), else 0.
+int crcSimDmaComplete(void);
+
+// A free-running nanosecond count, for CRC_BENCH_CYCLES and CRC_STATS_CYCLES
+uint32_t crcSimCycles(void);
+
+#ifndef CRC_STATS_CYCLES
+#define CRC_STATS_CYCLES() crcSimCycles()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_SIM_H
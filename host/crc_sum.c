@@ -0,0 +1,236 @@
+// crc_sum.c
+//
+// Command-line CRC of files, using every core (see crc_par.h), giving the
+// same results as the firmware in src/.  For factory test stations and log
+// servers checking images and records calculated on the target.
+//
+// Build (as one command), from the top of the repo:
+//
+//     cc -O2 -Isrc -Ihost -pthread -o crc_sum host/crc_sum.c host/crc_par.c
+//         host/crc_host.c src/crc_combine.c src/crc_sw.c src/crc_sw_tables.c
+//
+// Usage:
+//
+//     crc_sum [-m bytes|words|halfwords|zlib] [-i init] [-j threads] [-v] file...
+//     crc_sum -c [-m ...] [-i init] [-j threads] [-v] list...
+//
+//  -m  the CRC: the peripheral's, fed as for CRC_ORDER_BYTES (the default),
+//      CRC_ORDER_WORDS or CRC_ORDER_HALFWORDS, or the standard reflected
+//      CRC-32 (crc32Zlib(), with the final XOR)
+//  -i  the initial value, in hex (default FFFFFFFF)
+//  -j  threads in all (default one per online CPU)
+//  -c  check the "CRC  file" lines in each list, as printed without -c
+//  -v  print the throughput of each file to stderr
+//
+// Prints a "CRC  file" line for each file.  With -c, prints "file: OK" or
+// "file: FAILED" for each line.  Exits with status 0 if all is well, 1 if a
+// check failed, or 2 if a file couldn't be read.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "crc_par.h"
+
+static CrcParMode crcSumMode = CRC_PAR_BYTES;
+static uint32_t crcSumInit = 0xFFFFFFFFu;
+static int crcSumVerbose;
+
+static double crcSumNow(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+// The CRC of the file as printed; returns 0, or -1 with a message printed
+static int crcSumFile(const char *path, uint32_t *crc)
+{
+    double start = crcSumNow();
+
+    if (crcParFile(path, crcSumInit, crcSumMode, crc) < 0)
+    {
+        fprintf(stderr, "crc_sum: %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    if (crcSumMode == CRC_PAR_REFLECTED)
+    {
+        *crc ^= 0xFFFFFFFFu;
+    }
+
+    if (crcSumVerbose)
+    {
+        struct stat st;
+        double seconds = crcSumNow() - start;
+
+        if (stat(path, &st) == 0 && seconds > 0)
+        {
+            fprintf(stderr, "%s: %lld bytes, %.1f MB/s\n", path, (long long)st.st_size,
+                    (double)st.st_size / seconds / 1e6);
+        }
+    }
+    return 0;
+}
+
+// Returns the exit status for the list
+static int crcSumCheck(const char *list)
+{
+    FILE *f = strcmp(list, "-") ? fopen(list, "r") : stdin;
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t n;
+    int status = 0;
+
+    if (f == NULL)
+    {
+        fprintf(stderr, "crc_sum: %s: %s\n", list, strerror(errno));
+        return 2;
+    }
+
+    while ((n = getline(&line, &size, f)) >= 0)
+    {
+        unsigned long want;
+        char *path;
+        uint32_t got;
+
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r'))
+        {
+            line[--n] = '\0';
+        }
+        want = strtoul(line, &path, 16);
+        if (path != line + 8 || path[0] != ' ' || path[1] != ' ' || path[2] == '\0')
+        {
+            if (n)
+            {
+                fprintf(stderr, "crc_sum: %s: bad line: %s\n", list, line);
+                status = 2;
+            }
+            continue;
+        }
+        path += 2;
+
+        if (crcSumFile(path, &got) < 0)
+        {
+            status = 2;
+        }
+        else if (got != (uint32_t)want)
+        {
+            printf("%s: FAILED\n", path);
+            if (status == 0)
+            {
+                status = 1;
+            }
+        }
+        else
+        {
+            printf("%s: OK\n", path);
+        }
+    }
+
+    free(line);
+    if (f != stdin)
+    {
+        fclose(f);
+    }
+    return status;
+}
+
+static void crcSumUsage(void)
+{
+    fprintf(stderr, "usage: crc_sum [-c] [-m bytes|words|halfwords|zlib] [-i init] [-j threads] [-v] file...\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned threads = 0;
+    int check = 0;
+    int status = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "cm:i:j:v")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            check = 1;
+            break;
+        case 'm':
+            if (strcmp(optarg, "bytes") == 0)
+            {
+                crcSumMode = CRC_PAR_BYTES;
+            }
+            else if (strcmp(optarg, "words") == 0)
+            {
+                crcSumMode = CRC_PAR_WORDS;
+            }
+            else if (strcmp(optarg, "halfwords") == 0)
+            {
+                crcSumMode = CRC_PAR_HALFWORDS;
+            }
+            else if (strcmp(optarg, "zlib") == 0)
+            {
+                crcSumMode = CRC_PAR_REFLECTED;
+            }
+            else
+            {
+                crcSumUsage();
+            }
+            break;
+        case 'i':
+            crcSumInit = (uint32_t)strtoul(optarg, NULL, 16);
+            break;
+        case 'j':
+            threads = (unsigned)strtoul(optarg, NULL, 10);
+            break;
+        case 'v':
+            crcSumVerbose = 1;
+            break;
+        default:
+            crcSumUsage();
+        }
+    }
+    if (optind == argc)
+    {
+        crcSumUsage();
+    }
+
+    if (crcParStart(threads) < 0)
+    {
+        fprintf(stderr, "crc_sum: can't start threads, using one\n");
+    }
+
+    for (int i = optind; i < argc; i++)
+    {
+        uint32_t crc;
+        int s;
+
+        if (check)
+        {
+            s = crcSumCheck(argv[i]);
+        }
+        else if (crcSumFile(argv[i], &crc) < 0)
+        {
+            s = 2;
+        }
+        else
+        {
+            printf("%08X  %s\n", (unsigned)crc, argv[i]);
+            s = 0;
+        }
+        if (s > status)
+        {
+            status = s;
+        }
+    }
+
+    crcParStop();
+    return status;
+}
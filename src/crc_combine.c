@@ -0,0 +1,70 @@
+// crc_combine.c
+//
+// See crc_combine.h
+
+#include "crc_combine.h"
+#include "crc_ref.h"
+
+// x^(8 * 2^k) modulo the polynomial.  The polynomial is primitive, so
+//  x^(2^32) == x and the sequence repeats every 32 entries.
+static const uint32_t crcPow2Table[32] =
+{
+    0x00000100, 0x00010000, 0x04C11DB7, 0x490D678D,
+    0xE8A45605, 0x75BE46B7, 0xE6228B11, 0x567FDDEB,
+    0x88FE2237, 0x0E857E71, 0x7001E426, 0x075DE2B2,
+    0xF12A7F90, 0xF0B4A1C1, 0x58F46C0C, 0xC3395ADE,
+    0x96837F8C, 0x544037F9, 0x23B7B136, 0xB2E16BA8,
+    0x725E7BFA, 0xEC709B5D, 0xF77A7274, 0x2845D572,
+    0x034E2515, 0x79695942, 0x540CB128, 0x0B65D023,
+    0x3C344723, 0x00000002, 0x00000004, 0x00000010,
+};
+
+uint32_t crcMulMod(uint32_t a, uint32_t b)
+{
+    uint32_t product = 0;
+
+    // Horner's rule, most-significant bit of a first: multiplying by x is
+    //  one step of cleverCRC() with a zero data bit
+    for (int bit = 31; bit >= 0; bit--)
+    {
+        uint32_t pop = product & 0x80000000u;
+
+        product <<= 1;
+        if (pop)
+        {
+            product ^= CRC_POLY;
+        }
+        if ((a >> bit) & 1u)
+        {
+            product ^= b;
+        }
+    }
+
+    return product;
+}
+
+uint32_t crcShiftFactor(size_t len)
+{
+    uint32_t factor = 1;    // x^0
+
+    for (unsigned k = 0; len != 0; k++, len >>= 1)
+    {
+        if (len & 1u)
+        {
+            factor = crcMulMod(factor, crcPow2Table[k & 31]);
+        }
+    }
+
+    return factor;
+}
+
+uint32_t crcShift(uint32_t crcReg, size_t len)
+{
+    return crcMulMod(crcReg, crcShiftFactor(len));
+}
+
+uint32_t crc32Combine(uint32_t crcA, uint32_t crcB, size_t lenB)
+{
+    // crcB includes the initial value shifted past B; crcA takes its place
+    return crcShift(crcA ^ 0xFFFFFFFFu, lenB) ^ crcB;
+}
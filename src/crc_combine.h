@@ -0,0 +1,47 @@
+// crc_combine.h
+//
+// Combining CRCs of separately processed pieces of data.
+//
+// The "End Address" section relies on the CRC being linear: the effect of
+// what was already in crcReg and the effect of the new data bits can be
+// worked out separately and XORed together.  Feeding n zero bits into
+// cleverCRC() multiplies crcReg by x^n modulo the polynomial, so the CRC of
+// A followed by B is the CRC of A "shifted" past the length of B, XOR the
+// CRC of B calculated from a zero initial value.
+//
+// The shift is done by square-and-multiply, so it takes time proportional to
+// log(length); pieces of data can be processed in any order, on different
+// DMA channels, cores or threads, and joined afterwards.
+//
+// The results are for most-significant-bit-first CRCs with polynomial
+// 0x04C11DB7, in any CrcOrder; only the byte length matters.
+
+#ifndef CRC_COMBINE_H
+#define CRC_COMBINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// a * b modulo the polynomial, in GF(2)
+uint32_t crcMulMod(uint32_t a, uint32_t b);
+
+// x^(8 * len) modulo the polynomial: multiplying crcReg by this is the same
+//  as feeding len zero bytes into it
+uint32_t crcShiftFactor(size_t len);
+
+// crcReg after feeding len zero bytes into it
+uint32_t crcShift(uint32_t crcReg, size_t len);
+
+// The CRC of A followed by B, given crcA and crcB both calculated with the
+//  peripheral's initial value 0xFFFFFFFF, and the length of B in bytes
+uint32_t crc32Combine(uint32_t crcA, uint32_t crcB, size_t lenB);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_COMBINE_H
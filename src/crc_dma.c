@@ -0,0 +1,109 @@
+// crc_dma.c
+//
+// See crc_dma.h
+
+#include "crc_dma.h"
+#include "crc_port.h"
+#include "crc_stats.h"
+
+// The one transfer in progress (there is only one CRC peripheral)
+static struct
+{
+    CrcCtx *ctx;
+    const uint32_t *next;       // next word for the DMA controller
+    size_t words;               // words still to transfer after this one
+    const uint8_t *tail;        // bytes after the last word boundary
+    size_t tailLen;
+    CrcDoneFn done;
+    void *arg;
+    volatile int busy;
+#if CRC_STATS
+    uint32_t start;             // cycle count at crcUpdateDma()
+    size_t len;                 // bytes the DMA feeds
+#endif
+} crcDma;
+
+// Start the next DMA transfer of at most CRC_DMA_MAX_WORDS words
+static void crcDmaNext(void)
+{
+    size_t n = crcDma.words;
+
+    if (n > CRC_DMA_MAX_WORDS)
+    {
+        n = CRC_DMA_MAX_WORDS;
+    }
+    const uint32_t *src = crcDma.next;
+    crcDma.next += n;
+    crcDma.words -= n;
+    CRC_STATS_INC(dmaFeeds);
+    crcPortDmaStart(src, CRC_HW_DR_ADDR, n);
+}
+
+void crcUpdateDma(CrcCtx *ctx, const void *data, size_t len, CrcDoneFn done, void *arg)
+{
+    const uint8_t *p = data;
+    size_t head = (0u - (uintptr_t)p) & 3u;
+#if CRC_STATS
+    crcDma.start = CRC_STATS_CYCLES();
+#endif
+
+    if (ctx->order != CRC_ORDER_WORDS || len < head + 4 * (CRC_DMA_MIN_WORDS + 1))
+    {
+        crcUpdate(ctx, data, len);
+        done(ctx, arg);
+        return;
+    }
+
+    // The bytes before the first word boundary, and the first whole word if
+    //  it has to have pendXor folded into it, go through the CPU
+    crcUpdate(ctx, p, head);
+    p += head;
+    len -= head;
+    if (ctx->pendXor)
+    {
+        crcUpdate(ctx, p, 4);
+        p += 4;
+        len -= 4;
+    }
+
+    crcDma.ctx = ctx;
+    crcDma.next = (const uint32_t *)(const void *)p;
+    crcDma.words = len / 4;
+    crcDma.tail = p + (len & ~(size_t)3);
+    crcDma.tailLen = len & 3;
+    crcDma.done = done;
+    crcDma.arg = arg;
+    crcDma.busy = 1;
+#if CRC_STATS
+    crcDma.len = len & ~(size_t)3;
+#endif
+
+    crcDmaNext();
+}
+
+int crcDmaBusy(void)
+{
+    return crcDma.busy;
+}
+
+void crcDmaIrqHandler(void)
+{
+    if (!crcDma.busy)
+    {
+        return;
+    }
+
+    if (crcDma.words)
+    {
+        crcDmaNext();
+        return;
+    }
+
+    // The "End Address" fixup; the DMA left pendXor at zero
+    crcUpdate(crcDma.ctx, crcDma.tail, crcDma.tailLen);
+    crcDma.busy = 0;
+#if CRC_STATS
+    crcStatsAdd(CRC_BACKEND_DMA, crcDma.len, CRC_STATS_CYCLES() - crcDma.start);
+#endif
+    crcDma.done(crcDma.ctx, crcDma.arg);
+}
@@ -0,0 +1,71 @@
+// crc_dma.h
+//
+// DMA-fed CRC calculation for large buffers.  The CPU handles the bytes
+// before the first word boundary ("Start Address"), the first whole word
+// (which carries the initial value, see "Changing the Initial Value") and the
+// 1 to 3 bytes after the last word boundary ("End Address").  Everything in
+// between is written to the peripheral's data register by a memory-to-
+// peripheral DMA transfer while the CPU does something else.
+//
+// The DMA controller can only copy words as they are, so the DMA path is used
+// for CRC_ORDER_WORDS.  On the basic peripheral there is no way to have the
+// words reordered on the way, so CRC_ORDER_BYTES and CRC_ORDER_HALFWORDS data
+// is fed by the CPU (and the callback is made before crcUpdateDma() returns).
+//
+// The application provides crcPortDmaStart(), and calls crcDmaIrqHandler()
+// from its DMA transfer-complete interrupt.
+
+#ifndef CRC_DMA_H
+#define CRC_DMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Buffers with fewer whole words than this aren't worth setting up a DMA
+//  transfer for, so are fed by the CPU
+#ifndef CRC_DMA_MIN_WORDS
+#define CRC_DMA_MIN_WORDS 16u
+#endif
+
+// Largest number of words the DMA controller moves in one transfer (the
+//  NDTR/CNDTR register is 16 bits on every STM32 DMA controller)
+#ifndef CRC_DMA_MAX_WORDS
+#define CRC_DMA_MAX_WORDS 65535u
+#endif
+
+// Called, from the DMA interrupt, when all the data has been fed in.  The
+//  peripheral holds the updated CRC; call crcFinal(ctx) to get it, or
+//  crcUpdate()/crcUpdateDma() to continue.
+typedef void (*CrcDoneFn)(CrcCtx *ctx, void *arg);
+
+// Feed len bytes of data, at any alignment, into the CRC using DMA.  The
+//  data must not change, ctx must stay valid, and nothing else may use the
+//  peripheral until done() has been called.
+//
+// Returns immediately; done is called when the CRC has been updated.
+void crcUpdateDma(CrcCtx *ctx, const void *data, size_t len, CrcDoneFn done, void *arg);
+
+// Non-zero while a crcUpdateDma() is in progress
+int crcDmaBusy(void);
+
+// Call this from the DMA channel's transfer-complete interrupt
+void crcDmaIrqHandler(void);
+
+// Provided by the application: start a memory-to-peripheral transfer of
+//  words 32-bit words from src to dst, with memory increment, no peripheral
+//  increment, and a transfer-complete interrupt.  On parts with a data cache
+//  (F7, H7) the source must be cleaned from the cache first, and on H7 it
+//  must be in memory the chosen DMA controller can reach.
+void crcPortDmaStart(const uint32_t *src, volatile uint32_t *dst, size_t words);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_DMA_H
@@ -0,0 +1,136 @@
+// crc_image.c
+//
+// See crc_image.h
+
+#include "crc_image.h"
+#include "crc_combine.h"
+#include "crc_dma.h"
+
+static size_t crcImageSectorLen(const CrcImageIndex *index, uint32_t sector)
+{
+    size_t start = (size_t)sector * index->sectorSize;
+    size_t len = index->imageLen - start;
+
+    return (len < index->sectorSize) ? len : index->sectorSize;
+}
+
+// The CRC of sectors [0, count), from the index
+static uint32_t crcImageJoin(const CrcImageIndex *index, uint32_t count)
+{
+    uint32_t crc = 0xFFFFFFFFu;             // the CRC of no data
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        crc = crc32Combine(crc, index->sectorCrc[i], crcImageSectorLen(index, i));
+    }
+    return crc;
+}
+
+int crcImageCheckIndex(const CrcImageIndex *index)
+{
+    if (index->magic != CRC_IMAGE_MAGIC
+        || index->sectorSize == 0 || (index->sectorSize & 3u) || (index->imageLen & 3u)
+        || index->sectorCount != (index->imageLen + index->sectorSize - 1) / index->sectorSize)
+    {
+        return -1;
+    }
+    return (crcImageJoin(index, index->sectorCount) == index->imageCrc) ? 0 : -1;
+}
+
+int crcImageCheckSectors(const CrcImageIndex *index, const void *image, uint32_t first,
+                         uint32_t count)
+{
+    const uint8_t *p = image;
+
+    if (first > index->sectorCount || count > index->sectorCount - first)
+    {
+        return -1;
+    }
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        uint32_t crc = crcCalc(p + (size_t)i * index->sectorSize, crcImageSectorLen(index, i),
+                               0xFFFFFFFFu, CRC_ORDER_WORDS);
+        if (crc != index->sectorCrc[i])
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Note the CRC of v->sector, and move on to the next sector
+static void crcImageRecord(CrcImageVerify *v, uint32_t crc)
+{
+    if (crc != v->index->sectorCrc[v->sector])
+    {
+        if (v->firstBad < 0)
+        {
+            v->firstBad = (int32_t)v->sector;
+        }
+        v->result = -1;
+    }
+    v->imageCrc = crc32Combine(v->imageCrc, crc, crcImageSectorLen(v->index, v->sector));
+    v->sector++;
+}
+
+static void crcImageSectorDone(CrcCtx *ctx, void *arg);
+
+// Start the DMA for the next sector, or finish
+static void crcImageNext(CrcImageVerify *v)
+{
+    const CrcImageIndex *index = v->index;
+
+    // Sectors too short for DMA are done here, rather than by crcUpdateDma()
+    //  calling back before it returns, so that the stack doesn't grow
+    while (v->sector < index->sectorCount
+           && crcImageSectorLen(index, v->sector) < 4 * (CRC_DMA_MIN_WORDS + 1))
+    {
+        const uint8_t *p = v->image + (size_t)v->sector * index->sectorSize;
+        crcImageRecord(v, crcCalc(p, crcImageSectorLen(index, v->sector), 0xFFFFFFFFu,
+                                  CRC_ORDER_WORDS));
+    }
+
+    if (v->sector >= index->sectorCount)
+    {
+        if (v->imageCrc != index->imageCrc)
+        {
+            v->result = -1;
+        }
+        v->busy = 0;
+        v->done(v, v->arg);
+        return;
+    }
+
+    crcInit(&v->ctx, 0xFFFFFFFFu, CRC_ORDER_WORDS);
+    crcUpdateDma(&v->ctx, v->image + (size_t)v->sector * index->sectorSize,
+                 crcImageSectorLen(index, v->sector), crcImageSectorDone, v);
+}
+
+static void crcImageSectorDone(CrcCtx *ctx, void *arg)
+{
+    CrcImageVerify *v = arg;
+
+    crcImageRecord(v, crcFinal(ctx));
+    crcImageNext(v);
+}
+
+void crcImageVerifyStart(CrcImageVerify *v, const CrcImageIndex *index, const void *image,
+                         uint32_t first, CrcImageDoneFn done, void *arg)
+{
+    if (first > index->sectorCount)
+    {
+        first = index->sectorCount;
+    }
+
+    v->index = index;
+    v->image = image;
+    v->sector = first;
+    v->imageCrc = crcImageJoin(index, first);
+    v->firstBad = -1;
+    v->result = 0;
+    v->busy = 1;
+    v->done = done;
+    v->arg = arg;
+
+    crcImageNext(v);
+}
@@ -0,0 +1,81 @@
+// crc_image.h
+//
+// Checking a flash image against a per-sector CRC index stored next to it,
+// so that a bootloader only has to check the sectors it needs before
+// jumping to the application, and can leave the rest to DMA in the
+// background.
+//
+// Each sector's CRC is calculated as the peripheral does, from 0xFFFFFFFF
+// with CRC_ORDER_WORDS; the sector CRCs are joined with crc32Combine() into
+// the CRC of the whole image, which is the same as feeding the whole image
+// to the peripheral.  tools/crc_image_index.py makes the index.
+
+#ifndef CRC_IMAGE_H
+#define CRC_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CRC_IMAGE_MAGIC 0x58444943u     // "CIDX"
+
+// The index, as stored in flash
+typedef struct
+{
+    uint32_t magic;             // CRC_IMAGE_MAGIC
+    uint32_t imageLen;          // bytes; a multiple of 4
+    uint32_t sectorSize;        // bytes; a multiple of 4.  The last sector may be shorter.
+    uint32_t sectorCount;
+    uint32_t imageCrc;          // crcCalc(image, imageLen, 0xFFFFFFFF, CRC_ORDER_WORDS)
+    uint32_t sectorCrc[];       // crcCalc() of each sector, the same way
+} CrcImageIndex;
+
+typedef struct CrcImageVerify CrcImageVerify;
+
+// Called, from the DMA interrupt, when crcImageVerifyStart() has finished
+typedef void (*CrcImageDoneFn)(CrcImageVerify *v, void *arg);
+
+// A background check in progress; fill in by crcImageVerifyStart()
+struct CrcImageVerify
+{
+    const CrcImageIndex *index;
+    const uint8_t *image;
+    uint32_t sector;            // sector being checked
+    uint32_t imageCrc;          // CRC of the sectors so far
+    int32_t firstBad;           // first sector that didn't match, or -1
+    int result;                 // 0 if the whole image matched, or -1
+    volatile int busy;
+    CrcCtx ctx;
+    CrcImageDoneFn done;
+    void *arg;
+};
+
+// Check that the index is well formed and that its sector CRCs join up to
+//  its whole-image CRC.  Doesn't read the image.  Returns 0, or -1.
+int crcImageCheckIndex(const CrcImageIndex *index);
+
+// Check count sectors, starting with sector first, using the CPU.  Returns
+//  0 if they all match the index, or -1.
+int crcImageCheckSectors(const CrcImageIndex *index, const void *image, uint32_t first,
+                         uint32_t count);
+
+// Start checking sectors first to the end using DMA, and return
+//  immediately.  Sectors before first are taken as already checked (with
+//  crcImageCheckSectors()), so their CRCs come from the index.
+//
+// When done is called, v->imageCrc is the CRC of the whole image and
+//  v->result says whether it and every sector checked matched the index.
+//  Nothing else may use the peripheral until then.
+void crcImageVerifyStart(CrcImageVerify *v, const CrcImageIndex *index, const void *image,
+                         uint32_t first, CrcImageDoneFn done, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_IMAGE_H
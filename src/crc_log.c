@@ -0,0 +1,134 @@
+// crc_log.c
+//
+// See crc_log.h
+
+#include <string.h>
+
+#include "crc_log.h"
+#include "crc_combine.h"
+
+int crcLogInit(CrcLog *log, void *buf, size_t size, CrcLogRecord *rec, size_t recMax,
+               CrcOrder order)
+{
+    if (size == 0 || recMax == 0)
+    {
+        return -1;
+    }
+    if (order != CRC_ORDER_BYTES && (((uintptr_t)buf & 3u) || (size & 3u)))
+    {
+        return -1;
+    }
+
+    log->buf = buf;
+    log->size = size;
+    log->first = 0;
+    log->used = 0;
+    log->rec = rec;
+    log->recMax = recMax;
+    log->recFirst = 0;
+    log->recCount = 0;
+    log->crc = 0;
+    log->order = order;
+    return 0;
+}
+
+// The stored bytes at offset at, which may wrap round the end of buf
+static uint32_t crcLogRange(const CrcLog *log, size_t at, size_t len, uint32_t initValue)
+{
+    size_t n = log->size - at;
+    CrcCtx ctx;
+
+    if (n > len)
+    {
+        n = len;
+    }
+    crcInit(&ctx, initValue, log->order);
+    crcUpdate(&ctx, log->buf + at, n);
+    crcUpdate(&ctx, log->buf, len - n);
+    return crcFinal(&ctx);
+}
+
+int crcLogEvict(CrcLog *log)
+{
+    if (log->recCount == 0)
+    {
+        return -1;
+    }
+
+    const CrcLogRecord *r = &log->rec[log->recFirst];
+
+    log->used -= r->len;
+    log->crc ^= crcShift(r->crc, log->used);
+    log->first = (log->first + r->len) % log->size;
+    log->recFirst = (log->recFirst + 1) % log->recMax;
+    log->recCount--;
+    return 0;
+}
+
+int crcLogAppend(CrcLog *log, const void *data, size_t len)
+{
+    if (len > log->size || (log->order != CRC_ORDER_BYTES && (len & 3u)))
+    {
+        return -1;
+    }
+
+    while (log->size - log->used < len || log->recCount == log->recMax)
+    {
+        crcLogEvict(log);
+    }
+
+    size_t at = (log->first + log->used) % log->size;
+    size_t n = log->size - at;
+    if (n > len)
+    {
+        n = len;
+    }
+    memcpy(log->buf + at, data, n);
+    memcpy(log->buf, (const uint8_t *)data + n, len - n);
+
+    // The record's CRC, from the copy in the log
+    uint32_t crc = crcLogRange(log, at, len, 0);
+
+    CrcLogRecord *r = &log->rec[(log->recFirst + log->recCount) % log->recMax];
+    r->len = (uint32_t)len;
+    r->crc = crc;
+    log->recCount++;
+
+    log->crc = crcShift(log->crc, len) ^ crc;
+    log->used += len;
+    return 0;
+}
+
+uint32_t crcLogCrc(const CrcLog *log, uint32_t initValue)
+{
+    return crcShift(initValue, log->used) ^ log->crc;
+}
+
+int crcLogVerify(const CrcLog *log)
+{
+    return (crcLogRange(log, log->first, log->used, 0) == log->crc) ? 0 : -1;
+}
+
+size_t crcLogRead(const CrcLog *log, size_t i, void *out)
+{
+    if (i >= log->recCount)
+    {
+        return 0;
+    }
+
+    size_t at = log->first;
+    for (size_t k = 0; k < i; k++)
+    {
+        at = (at + log->rec[(log->recFirst + k) % log->recMax].len) % log->size;
+    }
+
+    size_t len = log->rec[(log->recFirst + i) % log->recMax].len;
+    size_t n = log->size - at;
+    if (n > len)
+    {
+        n = len;
+    }
+    memcpy(out, log->buf + at, n);
+    memcpy((uint8_t *)out + n, log->buf, len - n);
+    return len;
+}
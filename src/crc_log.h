@@ -0,0 +1,86 @@
+// crc_log.h
+//
+// A circular log of variable-length records that keeps the CRC of its live
+// window up to date as records are appended and the oldest are evicted,
+// without going back over the window.
+//
+// The log keeps c, the CRC of the window calculated from a zero initial
+// value, and the same for each record.  By linearity (see crc_combine.h):
+//
+//  - appending record R:   c = crcShift(c, len(R)) ^ crc(R)
+//  - evicting the oldest:  c = c ^ crcShift(crc(E), len(rest of window))
+//  - the window's CRC:     crcShift(initValue, len(window)) ^ c
+//
+// So each append feeds only the new record through the peripheral, read
+// back from the log's own storage, and the rest is a few crcShift() calls,
+// O(log n) each.  crcLogVerify() goes over the whole window, to check that
+// the stored records haven't been corrupted.
+//
+// For CRC_ORDER_WORDS and CRC_ORDER_HALFWORDS, buf must be word-aligned
+// and the buffer size and every record length multiples of 4, so that
+// records and the wrap-around both fall on word boundaries.
+
+#ifndef CRC_LOG_H
+#define CRC_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t len;
+    uint32_t crc;               // from a zero initial value
+} CrcLogRecord;
+
+typedef struct
+{
+    uint8_t *buf;
+    size_t size;
+    size_t first;               // offset in buf of the oldest byte
+    size_t used;                // bytes in the window
+
+    CrcLogRecord *rec;
+    size_t recMax;
+    size_t recFirst;            // index in rec of the oldest record
+    size_t recCount;
+
+    uint32_t crc;               // CRC of the window from a zero initial value
+    CrcOrder order;
+} CrcLog;
+
+// Set up an empty log using size bytes at buf for the data and recMax
+//  entries at rec for the records.  Returns 0, or -1 if the sizes or
+//  alignment don't suit order.
+int crcLogInit(CrcLog *log, void *buf, size_t size, CrcLogRecord *rec, size_t recMax,
+               CrcOrder order);
+
+// Append a record, evicting the oldest records until there is room for it.
+//  Uses the peripheral.  Returns 0, or -1 if it could never fit (or, for
+//  word orders, len isn't a multiple of 4).
+int crcLogAppend(CrcLog *log, const void *data, size_t len);
+
+// Evict the oldest record.  Returns 0, or -1 if the log is empty.
+int crcLogEvict(CrcLog *log);
+
+// The CRC of the window, as crcCalc() of its bytes in order would give
+uint32_t crcLogCrc(const CrcLog *log, uint32_t initValue);
+
+// Go over the window with the peripheral and check it against the running
+//  CRC.  Returns 0 if they match, or -1.
+int crcLogVerify(const CrcLog *log);
+
+// Copy the bytes of record i (0 being the oldest) to out, which must have
+//  room for its length.  Returns the length, or 0 if there is no record i.
+size_t crcLogRead(const CrcLog *log, size_t i, void *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_LOG_H
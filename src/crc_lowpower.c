@@ -0,0 +1,165 @@
+// crc_lowpower.c
+//
+// See crc_lowpower.h
+
+#include "crc_lowpower.h"
+#include "crc_dma.h"
+
+static struct
+{
+    CrcJob job[CRC_LP_JOBS];
+    uint32_t deadline[CRC_LP_JOBS];
+    unsigned count;
+    size_t bytes;               // data in the waiting jobs
+    int flushing;               // in crcLpFlush(), maybe in a done function
+} crcLp;
+
+static volatile int crcLpRunning;
+
+static void crcLpDmaDone(CrcCtx *ctx, void *arg)
+{
+    (void)ctx;
+    (void)arg;
+
+    crcLpRunning = 0;
+}
+
+// Sleep until the DMA has finished.  Interrupts are masked between the
+//  check and the WFI, so the DMA interrupt can't come in between and leave
+//  the core asleep; WFI still wakes for it with PRIMASK set, and it runs
+//  when they are unmasked after waking.  PRIMASK is put back as it was, so
+//  this doesn't enable interrupts for a caller that had them masked.
+static void crcLpWait(void)
+{
+#if defined(__arm__)
+    uint32_t primask;
+
+    __asm__ volatile ("mrs %0, primask" : "=r" (primask));
+    for (;;)
+    {
+        __asm__ volatile ("cpsid i" ::: "memory");
+        if (!crcLpRunning)
+        {
+            break;
+        }
+        __asm__ volatile ("wfi");
+        __asm__ volatile ("cpsie i" ::: "memory");
+    }
+    __asm__ volatile ("msr primask, %0" :: "r" (primask) : "memory");
+#else
+    while (crcLpRunning)
+    {
+    }
+#endif
+}
+
+static uint32_t crcLpEarliest(void)
+{
+    uint32_t earliest = crcLp.deadline[0];
+
+    for (unsigned i = 1; i < crcLp.count; i++)
+    {
+        if ((int32_t)(crcLp.deadline[i] - earliest) < 0)
+        {
+            earliest = crcLp.deadline[i];
+        }
+    }
+    return earliest;
+}
+
+void crcLpFlush(void)
+{
+    unsigned n = crcLp.count;
+
+    if (n == 0 || crcLp.flushing)
+    {
+        return;
+    }
+
+    crcLp.flushing = 1;
+    crcPortClock(1);
+    for (unsigned i = 0; i < n; i++)
+    {
+        const CrcJob *job = &crcLp.job[i];
+        CrcCtx ctx;
+
+        crcInit(&ctx, job->initValue, job->order);
+        crcLpRunning = 1;
+        crcUpdateDma(&ctx, job->data, job->len, crcLpDmaDone, NULL);
+        crcLpWait();
+        job->done(crcFinal(&ctx), job->arg);
+    }
+    crcPortClock(0);
+
+    // Keep any jobs the done functions posted for the next batch
+    crcLp.bytes = 0;
+    for (unsigned i = n; i < crcLp.count; i++)
+    {
+        crcLp.job[i - n] = crcLp.job[i];
+        crcLp.deadline[i - n] = crcLp.deadline[i];
+        crcLp.bytes += crcLp.job[i].len;
+    }
+    crcLp.count -= n;
+    crcLp.flushing = 0;
+
+    if (crcLp.count)
+    {
+        crcPortLowPowerWake(crcLpEarliest());
+    }
+}
+
+int crcLpPost(const CrcJob *job, uint32_t deadline)
+{
+    if (crcLp.count == CRC_LP_JOBS)
+    {
+        if (crcLp.flushing)
+        {
+            return -1;
+        }
+        crcLpFlush();
+    }
+
+    int earlier = crcLp.count == 0 || (int32_t)(deadline - crcLpEarliest()) < 0;
+
+    crcLp.job[crcLp.count] = *job;
+    crcLp.deadline[crcLp.count] = deadline;
+    crcLp.count++;
+    crcLp.bytes += job->len;
+
+    if (crcLp.flushing)
+    {
+        return 0;               // crcLpFlush() will see to it
+    }
+    if (crcLp.bytes >= CRC_LP_BATCH_BYTES)
+    {
+        crcLpFlush();
+    }
+    else if (earlier)
+    {
+        crcPortLowPowerWake(deadline);
+    }
+    return 0;
+}
+
+void crcLpPoll(uint32_t now)
+{
+    if (crcLp.count == 0)
+    {
+        return;
+    }
+
+    uint32_t earliest = crcLpEarliest();
+    if (crcLp.bytes >= CRC_LP_BATCH_BYTES || (int32_t)(now - earliest) >= 0)
+    {
+        crcLpFlush();
+    }
+    else
+    {
+        crcPortLowPowerWake(earliest);
+    }
+}
+
+unsigned crcLpPending(void)
+{
+    return crcLp.count;
+}
@@ -0,0 +1,78 @@
+// crc_lowpower.h
+//
+// Batching CRC jobs for battery-powered parts (e.g. L4, U5), so that the
+// core wakes up to run CRCs as seldom as possible.
+//
+// Jobs are held until CRC_LP_BATCH_BYTES of data is waiting, the ring is
+// full, or the earliest job's deadline comes.  Then, in crcLpPoll(), the
+// CRC peripheral clock is turned on, each job's data is fed by DMA (see
+// crc_dma.h) while the core waits in WFI, the done functions are called,
+// and the clock is turned off again.
+//
+// The application provides:
+//  - crcPortClock(): gate the CRC peripheral clock (RCC AHB1ENR.CRCEN);
+//  - crcPortLowPowerWake(): wake the core at a given tick, e.g. with an
+//    LPTIM or RTC alarm, so that crcLpPoll() runs by a job's deadline;
+//  - crcPortDmaStart(), and a DMA interrupt that calls crcDmaIrqHandler().
+// The core must only enter Sleep, not Stop, while waiting, as the DMA needs
+// the bus clocks; SLEEPDEEP must be clear.
+//
+// Ticks are whatever the application's wakeup timer counts, and wrap.
+// crcLpPost() and crcLpPoll() must be called from the same context (e.g.
+// the main loop); the jobs' data must stay unchanged until done is called.
+
+#ifndef CRC_LOWPOWER_H
+#define CRC_LOWPOWER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc_queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Jobs held at most
+#ifndef CRC_LP_JOBS
+#define CRC_LP_JOBS 16u
+#endif
+
+// Run the batch once this much data is waiting
+#ifndef CRC_LP_BATCH_BYTES
+#define CRC_LP_BATCH_BYTES 4096u
+#endif
+
+// Hold a job until a batch is worth running, or until the tick deadline.
+//  Runs the batch first if the ring is full, and afterwards if it has
+//  grown to CRC_LP_BATCH_BYTES.  Returns 0, or -1 if the ring is full and
+//  this is called from a done function.
+int crcLpPost(const CrcJob *job, uint32_t deadline);
+
+// Call on every wakeup with the current tick: runs the batch if it is big
+//  enough or a deadline has come, and otherwise asks for a wakeup at the
+//  earliest deadline
+void crcLpPoll(uint32_t now);
+
+// Run every waiting job now, e.g. before entering Stop mode.  Interrupts
+//  are unmasked for a moment each time the core wakes while waiting for a
+//  transfer, so that the DMA interrupt can run, even if the caller had
+//  masked them; PRIMASK is as it was on return.  crcLpPost() and
+//  crcLpPoll() may call this.
+void crcLpFlush(void);
+
+// Number of jobs waiting
+unsigned crcLpPending(void);
+
+// Provided by the application: turn the CRC peripheral clock on or off
+void crcPortClock(int on);
+
+// Provided by the application: make sure the core wakes up, and
+//  crcLpPoll() is called, by the given tick
+void crcPortLowPowerWake(uint32_t tick);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_LOWPOWER_H
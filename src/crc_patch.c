@@ -0,0 +1,57 @@
+// crc_patch.c
+//
+// See crc_patch.h
+
+#include "crc_patch.h"
+#include "crc_combine.h"
+#include "crc_sw.h"
+
+// The difference between old and new data is put together in this many
+//  bytes at a time
+#define CRC_PATCH_CHUNK 64u
+
+uint32_t crcPatch(uint32_t oldCrc, size_t offset, const void *oldBytes, const void *newBytes,
+                  size_t len, size_t totalLen, CrcOrder order)
+{
+    const uint8_t *oldP = oldBytes;
+    const uint8_t *newP = newBytes;
+    uint32_t buf[CRC_PATCH_CHUNK / 4];
+    uint8_t *diff = (uint8_t *)buf;
+
+    // CRC_ORDER_WORDS and CRC_ORDER_HALFWORDS process whole words, so widen
+    //  the change to word boundaries; the difference is zero in the extra
+    //  bytes
+    size_t start = offset;
+    size_t end = offset + len;
+    if (order != CRC_ORDER_BYTES)
+    {
+        start &= ~(size_t)3;
+        end = (end + 3) & ~(size_t)3;
+    }
+
+    // CRC of the difference, from a zero initial value; zero bytes before
+    //  the change would leave it at zero, so they can be skipped
+    uint32_t crc = 0;
+    for (size_t pos = start; pos < end; )
+    {
+        size_t n = end - pos;
+        if (n > CRC_PATCH_CHUNK)
+        {
+            n = CRC_PATCH_CHUNK;
+        }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t at = pos + i;
+            diff[i] = (at >= offset && at < offset + len)
+                    ? (uint8_t)(oldP[at - offset] ^ newP[at - offset])
+                    : 0;
+        }
+
+        // diff is word-aligned, as the buffer is for the other orders
+        crc = crcSwUpdate(crc, diff, n, order);
+        pos += n;
+    }
+
+    return oldCrc ^ crcShift(crc, totalLen - end);
+}
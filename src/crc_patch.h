@@ -0,0 +1,37 @@
+// crc_patch.h
+//
+// Updating the CRC of a large buffer after a few bytes of it have changed,
+// without going over the whole buffer again.
+//
+// The CRC is linear, as in the "End Address" section: changing some bytes
+// changes the CRC by the CRC (from a zero initial value) of the XOR of the
+// old and new bytes, shifted past the rest of the buffer.  So the update
+// takes time proportional to the length of the change, plus log(distance
+// from the change to the end of the buffer).  The initial value and any
+// final XOR don't matter, as they cancel out.
+
+#ifndef CRC_PATCH_H
+#define CRC_PATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Return the CRC of a totalLen byte buffer after len bytes at offset have
+//  changed from oldBytes to newBytes, given its CRC oldCrc before.
+//
+// For CRC_ORDER_WORDS and CRC_ORDER_HALFWORDS the buffer must start on a
+//  word boundary and totalLen must be a multiple of 4.
+uint32_t crcPatch(uint32_t oldCrc, size_t offset, const void *oldBytes, const void *newBytes,
+                  size_t len, size_t totalLen, CrcOrder order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_PATCH_H
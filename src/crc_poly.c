@@ -0,0 +1,113 @@
+// crc_poly.c
+//
+// See crc_poly.h.  As in stm32crc.hpp, the shift register is 32 bits:
+// most-significant-bit-first CRCs keep the CRC in the top width bits, so
+// the code is the same as cleverCRC() for every width, and reflected CRCs
+// keep it reversed in the bottom bits.
+
+#include "crc_poly.h"
+#include "crc_stats.h"
+
+// Reverse the order of the low width bits of x
+static uint32_t crcPolyReflect(uint32_t x, unsigned width)
+{
+    uint32_t r = 0;
+
+    for (unsigned i = 0; i < width; i++)
+    {
+        r = (r << 1) | ((x >> i) & 1u);
+    }
+    return r;
+}
+
+static uint32_t crcPolyMask(unsigned width)
+{
+    return (width >= 32) ? 0xFFFFFFFFu : ((1u << width) - 1u);
+}
+
+int crcPolyInit(CrcPoly *crc, const CrcParams *params)
+{
+    unsigned width = params->width;
+    uint32_t poly = params->poly & crcPolyMask(width);
+
+    if (width < 8 || width > 32)
+    {
+        return -1;
+    }
+
+    crc->params = *params;
+    crc->useHw = crcProgSupported(params);     // never on the basic peripheral
+
+    if (params->refIn)
+    {
+        uint32_t regPoly = crcPolyReflect(poly, width);
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t r = i;
+            for (int b = 0; b < 8; b++)
+            {
+                r = (r & 1u) ? (r >> 1) ^ regPoly : r >> 1;
+            }
+            crc->table[i] = r;
+        }
+    }
+    else
+    {
+        uint32_t regPoly = poly << (32 - width);
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t r = i << 24;
+            for (int b = 0; b < 8; b++)
+            {
+                r = (r & 0x80000000u) ? (r << 1) ^ regPoly : r << 1;
+            }
+            crc->table[i] = r;
+        }
+    }
+    return 0;
+}
+
+uint32_t crcPolySwCalc(const CrcPoly *crc, const void *data, size_t len)
+{
+    const CrcParams *params = &crc->params;
+    unsigned width = params->width;
+    uint32_t mask = crcPolyMask(width);
+    const uint8_t *p = data;
+    uint32_t r;
+    CRC_STATS_START(start);
+
+    if (params->refIn)
+    {
+        r = crcPolyReflect(params->init & mask, width);
+        for (size_t i = 0; i < len; i++)
+        {
+            r = (r >> 8) ^ crc->table[(r ^ p[i]) & 0xFFu];
+        }
+    }
+    else
+    {
+        r = (params->init & mask) << (32 - width);
+        for (size_t i = 0; i < len; i++)
+        {
+            r = (r << 8) ^ crc->table[(r >> 24) ^ p[i]];
+        }
+        r >>= 32 - width;
+    }
+
+    // r is now in the input bit order
+    if (params->refIn != params->refOut)
+    {
+        r = crcPolyReflect(r, width);
+    }
+    CRC_STATS_END(start, CRC_BACKEND_SW, len);
+    return (r ^ params->xorOut) & mask;
+}
+
+uint32_t crcPolyCalc(const CrcPoly *crc, const void *data, size_t len)
+{
+    if (crc->useHw && len >= CRC_POLY_HW_MIN)
+    {
+        return crcProgCalc(&crc->params, data, len);
+    }
+    return crcPolySwCalc(crc, data, len);
+}
@@ -0,0 +1,60 @@
+// crc_poly.h
+//
+// CRCs with other polynomials and widths (8 to 32 bits), such as CRC-32C,
+// described by a CrcParams from crc_prog.h.
+//
+// The basic peripheral can't help with these.  Its result is the data
+// modulo 0x04C11DB7, and the data modulo any other polynomial can't be
+// worked out from that, whatever transform is applied afterwards.  So
+// crcPolyCalc() uses the "more capable" peripheral when crcProgSupported()
+// says it can do the CRC, and a 256-entry table built by crcPolyInit()
+// otherwise, which includes every CRC on the basic peripheral (it can't
+// take the 8- and 16-bit writes for partial words).  bench/crc_bench.c compares the two.
+//
+// crcPolyCalc() uses the peripheral, so it mustn't be called while another
+// CRC is in progress on it.
+
+#ifndef CRC_POLY_H
+#define CRC_POLY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc_prog.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shorter data than this goes through the table even if the peripheral
+//  can do the CRC, as setting the peripheral up and back costs more
+#ifndef CRC_POLY_HW_MIN
+#define CRC_POLY_HW_MIN 16u
+#endif
+
+typedef struct
+{
+    CrcParams params;
+    int useHw;                  // the peripheral can calculate this CRC
+    uint32_t table[256];        // in the shift register's bit order
+} CrcPoly;
+
+// Build the table for params (width 8 to 32), and find out whether the
+//  peripheral can be used instead.  Returns 0, or -1 for a width the table
+//  code can't do.  The first call (or the first crcProgCaps() from
+//  anywhere) runs crcDetect(), which writes INIT, POL and CR and resets the
+//  peripheral.  So make it, or call crcProgCaps() once at startup, before
+//  any CrcCtx, queued job or DMA transfer is using the peripheral.
+int crcPolyInit(CrcPoly *crc, const CrcParams *params);
+
+// The CRC of len bytes of data, using the peripheral or the table
+uint32_t crcPolyCalc(const CrcPoly *crc, const void *data, size_t len);
+
+// The same, always using the table
+uint32_t crcPolySwCalc(const CrcPoly *crc, const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_POLY_H
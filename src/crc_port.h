@@ -0,0 +1,121 @@
+// crc_port.h
+//
+// Access to the STM32 CRC peripheral registers, and the core instructions
+// from the "Builtins" section of stm32crc.adoc.
+//
+// To run the library somewhere other than a real STM32 (or to use your own
+// register definitions), define CRC_PORT_HEADER to the name of a header that
+// provides CRC_HW_RESET(), CRC_HW_WRITE(), CRC_HW_READ() and CRC_HW_DR_ADDR,
+// and for crc_prog.c the rest of the CRC_HW_ macros below.
+//
+// The CRC peripheral clock must be enabled (RCC AHB enable register) before
+// any of the library functions are called.
+
+#ifndef CRC_PORT_H
+#define CRC_PORT_H
+
+#include <stdint.h>
+
+#if defined(CRC_PORT_HEADER)
+
+#include CRC_PORT_HEADER
+
+#else
+
+// Same address on F0/F1/F2/F3/F4/F7/L1/L4/G4; H7 parts need 0x58024C00
+#ifndef CRC_PORT_BASE
+#define CRC_PORT_BASE 0x40023000u
+#endif
+
+typedef struct
+{
+    volatile uint32_t DR;       // data register: write data, read CRC
+    volatile uint32_t IDR;      // independent data register (not used)
+    volatile uint32_t CR;       // control register: bit 0 resets the unit
+    uint32_t reserved;
+    volatile uint32_t INIT;     // "more capable" peripheral only
+    volatile uint32_t POL;      // "more capable" peripheral only
+} CrcRegs;
+
+#define CRC_REGS ((CrcRegs *)CRC_PORT_BASE)
+
+#define CRC_HW_RESET()   (CRC_REGS->CR = 1u)
+#define CRC_HW_WRITE(w)  (CRC_REGS->DR = (w))
+#define CRC_HW_READ()    (CRC_REGS->DR)
+#define CRC_HW_DR_ADDR   (&CRC_REGS->DR)     // DMA destination
+
+// The "more capable" peripheral also takes 8- and 16-bit writes to DR, and
+//  has a programmable initial value and polynomial
+#define CRC_HW_WRITE8(b)    (*(volatile uint8_t *)&CRC_REGS->DR = (uint8_t)(b))
+#define CRC_HW_WRITE16(h)   (*(volatile uint16_t *)&CRC_REGS->DR = (uint16_t)(h))
+#define CRC_HW_SET_CR(v)    (CRC_REGS->CR = (v))
+#define CRC_HW_GET_CR()     (CRC_REGS->CR)
+#define CRC_HW_SET_INIT(v)  (CRC_REGS->INIT = (v))
+#define CRC_HW_GET_INIT()   (CRC_REGS->INIT)
+#define CRC_HW_SET_POL(v)   (CRC_REGS->POL = (v))
+#define CRC_HW_GET_POL()    (CRC_REGS->POL)
+
+#endif // CRC_PORT_HEADER
+
+// A 32-bit word that may alias any other object (e.g. a uint8_t buffer)
+#if defined(__GNUC__)
+typedef uint32_t __attribute__((__may_alias__)) CrcWord;
+#else
+typedef uint32_t CrcWord;
+#endif
+
+// REV: reverse the order of the bytes in a word.  GCC emits a single REV
+//  instruction for this on every Cortex-M core.
+static inline uint32_t crcRev(uint32_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_bswap32(x);
+#else
+    return (x >> 24) | ((x >> 8) & 0x0000FF00u) | ((x << 8) & 0x00FF0000u) | (x << 24);
+#endif
+}
+
+// ROR #16: swap the two halfwords of a word, so that the halfword at the
+//  lower address is processed first.  GCC emits a single ROR.
+static inline uint32_t crcRor16(uint32_t x)
+{
+    return (x >> 16) | (x << 16);
+}
+
+// RBIT: reverse the order of the bits in a word.  Cortex-M3, M4 and M7 have
+//  the instruction; M0 and M0+ don't, so reverse a nibble at a time instead.
+#if defined(__ARM_ARCH_ISA_THUMB) && (__ARM_ARCH_ISA_THUMB >= 2)
+
+#define CRC_HAVE_RBIT 1
+
+static inline uint32_t crcRbit(uint32_t x)
+{
+    uint32_t r;
+    __asm__ ("rbit %0, %1" : "=r" (r) : "r" (x));
+    return r;
+}
+
+#else
+
+#define CRC_HAVE_RBIT 0
+
+static inline uint32_t crcRbit(uint32_t x)
+{
+    static const uint8_t rev4[16] =
+    {
+        0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+        0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+    };
+    uint32_t r = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        r = (r << 4) | rev4[x & 0xF];
+        x >>= 4;
+    }
+    return r;
+}
+
+#endif
+
+#endif // CRC_PORT_H
@@ -0,0 +1,234 @@
+// crc_prog.c
+//
+// See crc_prog.h
+
+#include "crc_prog.h"
+#include "stm32crc.h"
+#include "crc_port.h"
+#include "crc_stats.h"
+#include "crc_ref.h"
+
+// CRC_CR fields on the "more capable" peripheral
+#define CRC_CR_RESET         0x01u
+#define CRC_CR_POLYSIZE_32   (0u << 3)
+#define CRC_CR_POLYSIZE_16   (1u << 3)
+#define CRC_CR_POLYSIZE_8    (2u << 3)
+#define CRC_CR_POLYSIZE_7    (3u << 3)
+#define CRC_CR_REV_IN_BYTE   (1u << 5)
+#define CRC_CR_REV_OUT       (1u << 7)
+
+const CrcParams crcParamsCrc32       = { 32, 1, 1, 0x04C11DB7u, 0xFFFFFFFFu, 0xFFFFFFFFu };
+const CrcParams crcParamsCrc32Mpeg2  = { 32, 0, 0, 0x04C11DB7u, 0xFFFFFFFFu, 0x00000000u };
+const CrcParams crcParamsCrc32C      = { 32, 1, 1, 0x1EDC6F41u, 0xFFFFFFFFu, 0xFFFFFFFFu };
+const CrcParams crcParamsCrc32K      = { 32, 1, 1, 0x741B8CD7u, 0xFFFFFFFFu, 0xFFFFFFFFu };
+const CrcParams crcParamsCrc16Ccitt  = { 16, 0, 0, 0x1021u,     0xFFFFu,     0x0000u };
+const CrcParams crcParamsCrc16Modbus = { 16, 1, 1, 0x8005u,     0xFFFFu,     0x0000u };
+const CrcParams crcParamsCrc8Smbus   = { 8,  0, 0, 0x07u,       0x00u,       0x00u };
+
+static int crcCaps = -1;
+
+// On the basic peripheral, the one CRC it can do goes through crcUpdate()
+//  instead, as it only takes 32-bit writes
+static CrcCtx crcProgCtx;
+static int crcProgBasic;
+
+static uint32_t crcWidthMask(unsigned width)
+{
+    return (width >= 32) ? 0xFFFFFFFFu : ((1u << width) - 1u);
+}
+
+unsigned crcDetect(void)
+{
+    unsigned caps = 0;
+
+    // On the basic peripheral these registers are reserved: writes are
+    //  ignored and reads give zero
+    CRC_HW_SET_INIT(0x12345678u);
+    if (CRC_HW_GET_INIT() == 0x12345678u)
+    {
+        caps |= CRC_CAP_INIT;
+    }
+    CRC_HW_SET_INIT(0xFFFFFFFFu);
+
+    CRC_HW_SET_POL(0x00001021u);
+    if (CRC_HW_GET_POL() == 0x00001021u)
+    {
+        caps |= CRC_CAP_POLY;
+    }
+    CRC_HW_SET_POL(CRC_POLY);
+
+    CRC_HW_SET_CR(CRC_CR_REV_OUT);
+    if (CRC_HW_GET_CR() & CRC_CR_REV_OUT)
+    {
+        caps |= CRC_CAP_REV;
+    }
+    CRC_HW_RESET();
+
+    crcCaps = (int)caps;
+    return caps;
+}
+
+unsigned crcProgCaps(void)
+{
+    return (crcCaps < 0) ? crcDetect() : (unsigned)crcCaps;
+}
+
+int crcProgSupported(const CrcParams *params)
+{
+    unsigned caps = crcProgCaps();
+    uint32_t mask = crcWidthMask(params->width);
+
+    if (caps == 0)
+    {
+        return 0;                       // no 8- or 16-bit writes
+    }
+    if (params->width != 7 && params->width != 8 && params->width != 16 && params->width != 32)
+    {
+        return 0;
+    }
+    if ((params->poly & 1u) == 0)
+    {
+        return 0;                       // even polynomials aren't supported
+    }
+    if ((params->width != 32 || params->poly != CRC_POLY) && !(caps & CRC_CAP_POLY))
+    {
+        return 0;
+    }
+    if ((params->init & mask) != mask && !(caps & CRC_CAP_INIT))
+    {
+        return 0;
+    }
+    if ((params->refIn || params->refOut) && !(caps & CRC_CAP_REV))
+    {
+        return 0;
+    }
+    return 1;
+}
+
+// The basic peripheral's own CRC, at any initial value
+static int crcProgIsBasic(const CrcParams *params)
+{
+    return params->width == 32 && params->poly == CRC_POLY && !params->refIn && !params->refOut;
+}
+
+int crcProgStart(const CrcParams *params)
+{
+    crcProgBasic = 0;
+    if (!crcProgSupported(params))
+    {
+        if (!crcProgIsBasic(params))
+        {
+            return -1;
+        }
+        crcProgBasic = 1;
+        crcInit(&crcProgCtx, params->init, CRC_ORDER_BYTES);
+        return 0;
+    }
+
+    uint32_t cr = CRC_CR_RESET;
+    switch (params->width)
+    {
+    case 7:  cr |= CRC_CR_POLYSIZE_7;  break;
+    case 8:  cr |= CRC_CR_POLYSIZE_8;  break;
+    case 16: cr |= CRC_CR_POLYSIZE_16; break;
+    default: cr |= CRC_CR_POLYSIZE_32; break;
+    }
+
+    // Words are REVed as they are written, so that bytes go in address
+    //  order; reversing by byte then makes each byte least-significant bit
+    //  first, and works the same for the 8- and 16-bit writes
+    if (params->refIn)
+    {
+        cr |= CRC_CR_REV_IN_BYTE;
+    }
+    if (params->refOut)
+    {
+        cr |= CRC_CR_REV_OUT;
+    }
+
+    if ((unsigned)crcCaps & CRC_CAP_POLY)
+    {
+        CRC_HW_SET_POL(params->poly);
+    }
+    if ((unsigned)crcCaps & CRC_CAP_INIT)
+    {
+        CRC_HW_SET_INIT(params->init);
+    }
+    CRC_HW_SET_CR(cr);                  // reset loads INIT into the data register
+    return 0;
+}
+
+static void crcProgFeed(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    // Bytes before the first word boundary
+    while (len && ((uintptr_t)p & 3u))
+    {
+        CRC_HW_WRITE8(*p++);
+        len--;
+    }
+
+    const CrcWord *w = (const CrcWord *)p;
+    for (size_t words = len / 4; words > 0; words--)
+    {
+        CRC_HW_WRITE(crcRev(*w++));
+    }
+    p = (const uint8_t *)w;
+
+    // Bytes after the last word boundary: no read-back needed
+    if (len & 2u)
+    {
+        CRC_HW_WRITE16(((uint32_t)p[0] << 8) | p[1]);
+        p += 2;
+    }
+    if (len & 1u)
+    {
+        CRC_HW_WRITE8(*p);
+    }
+}
+
+void crcProgUpdate(const void *data, size_t len)
+{
+    if (crcProgBasic)
+    {
+        crcUpdate(&crcProgCtx, data, len);
+        return;
+    }
+
+    CRC_STATS_START(start);
+    crcProgFeed(data, len);
+    CRC_STATS_END(start, CRC_BACKEND_PROG, len);
+}
+
+uint32_t crcProgFinal(const CrcParams *params)
+{
+    uint32_t mask = crcWidthMask(params->width);
+
+    if (crcProgBasic)
+    {
+        crcProgBasic = 0;
+        return crcFinal(&crcProgCtx) ^ params->xorOut;
+    }
+
+    uint32_t crc = (CRC_HW_READ() ^ params->xorOut) & mask;
+
+    if ((unsigned)crcCaps & CRC_CAP_POLY)
+    {
+        CRC_HW_SET_POL(CRC_POLY);
+    }
+    if ((unsigned)crcCaps & CRC_CAP_INIT)
+    {
+        CRC_HW_SET_INIT(0xFFFFFFFFu);
+    }
+    CRC_HW_RESET();
+
+    return crc;
+}
+
+uint32_t crcProgCalc(const CrcParams *params, const void *data, size_t len)
+{
+    crcProgStart(params);
+    crcProgUpdate(data, len);
+    return crcProgFinal(params);
+}
@@ -0,0 +1,89 @@
+// crc_prog.h
+//
+// CRCs on the "more capable" CRC peripheral found on some STM32 parts (e.g.
+// F0x2/F0x7, F3, F7, L0, L4, G0, G4, H7), which has a programmable
+// polynomial, initial value and CRC width, and can reverse the input and
+// output bit order itself.
+//
+// Compared with the basic peripheral tricks:
+//  - bytes before the first and after the last word boundary are written
+//    with 8- and 16-bit writes, instead of the "End Address" read-back;
+//  - the initial value goes in the INIT register, instead of being XORed
+//    into the first data word;
+//  - bit reflection is done by REV_IN and REV_OUT, instead of RBIT.
+//
+// This lets the peripheral do CRC-16 and CRC-8 as well; see the parameter
+// sets below.  Data is processed in increasing address order.
+//
+// On the basic peripheral, which only takes 32-bit writes, crcProgStart()
+// still accepts its own CRC (polynomial 0x04C11DB7, 32 bits, not
+// reflected, any initial value), and does it with crcInit() and
+// crcUpdate(), using the "End Address" read-back for partial words.
+
+#ifndef CRC_PROG_H
+#define CRC_PROG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What crcDetect() found
+#define CRC_CAP_INIT 0x01u      // programmable initial value
+#define CRC_CAP_POLY 0x02u      // programmable polynomial and width
+#define CRC_CAP_REV  0x04u      // REV_IN / REV_OUT bit reversal
+
+// A CRC, as in "Common Variations on CRC Computations"
+typedef struct
+{
+    uint8_t width;              // 7, 8, 16 or 32 bits
+    uint8_t refIn;              // non-zero: each byte least-significant bit first
+    uint8_t refOut;             // non-zero: reverse the bit order of the CRC
+    uint32_t poly;              // without the top bit; must be odd
+    uint32_t init;
+    uint32_t xorOut;
+} CrcParams;
+
+extern const CrcParams crcParamsCrc32;          // zlib, Ethernet
+extern const CrcParams crcParamsCrc32Mpeg2;     // the basic peripheral
+extern const CrcParams crcParamsCrc32C;         // Castagnoli, iSCSI
+extern const CrcParams crcParamsCrc32K;         // Koopman, reflected like CRC-32C
+extern const CrcParams crcParamsCrc16Ccitt;     // CCITT-FALSE
+extern const CrcParams crcParamsCrc16Modbus;
+extern const CrcParams crcParamsCrc8Smbus;
+
+// Find out which features the CRC peripheral has, by writing its registers
+//  and reading them back.  Leaves the peripheral reset to basic behaviour.
+unsigned crcDetect(void);
+
+// What crcDetect() found, running it only the first time
+unsigned crcProgCaps(void);
+
+// Non-zero if the "more capable" peripheral can calculate this CRC, going
+//  by crcDetect(); always zero on the basic peripheral
+int crcProgSupported(const CrcParams *params);
+
+// Set the peripheral up for params and start a new CRC.  Returns 0, or -1 if
+//  the peripheral can't calculate this CRC (neither crcProgSupported() nor
+//  the basic peripheral's own CRC).
+int crcProgStart(const CrcParams *params);
+
+// Feed len bytes of data, at any alignment, into the CRC
+void crcProgUpdate(const void *data, size_t len);
+
+// Return the final CRC, and put the peripheral back to basic behaviour
+//  (polynomial 0x04C11DB7, initial value 0xFFFFFFFF) for the rest of the
+//  library
+uint32_t crcProgFinal(const CrcParams *params);
+
+// One-shot: crcProgStart(), crcProgUpdate(), crcProgFinal().  crcProgStart()
+//  must accept params.
+uint32_t crcProgCalc(const CrcParams *params, const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_PROG_H
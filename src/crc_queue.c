@@ -0,0 +1,194 @@
+// crc_queue.c
+//
+// See crc_queue.h.
+//
+// Each slot's sequence number says whose turn it is: slot i of lap n is
+// free for the producer claiming position p = n * CRC_QUEUE_LEN + i when
+// seq == p, and holds a job for the consumer when seq == p + 1.  A producer
+// claims a position by advancing tail with a compare-and-swap, fills the
+// slot in, then publishes it by setting seq.  A producer interrupted between
+// claiming and publishing holds up the consumer, but not other producers.
+//
+// Slots store seq minus the slot number, so that the zeroed ring is ready
+// to use without any setup.
+
+#include "crc_queue.h"
+
+#if CRC_QUEUE_DMA
+#include "crc_dma.h"
+#endif
+
+static struct
+{
+    struct
+    {
+        uint32_t seq;
+        CrcJob job;
+    } slot[CRC_QUEUE_LEN];
+
+    uint32_t tail;              // next position for a producer
+    uint32_t head;              // next position for the consumer
+
+    CrcJob job;                 // the job being run
+    CrcCtx ctx;
+#if CRC_QUEUE_DMA
+    volatile int running;       // a job is waiting for the DMA
+    int inService;              // in crcUpdateDma(), called from the service
+#endif
+} crcQueue;
+
+static uint32_t crcSeqLoad(uint32_t pos)
+{
+    uint32_t i = pos % CRC_QUEUE_LEN;
+
+    return __atomic_load_n(&crcQueue.slot[i].seq, __ATOMIC_ACQUIRE) + i;
+}
+
+static void crcSeqStore(uint32_t pos, uint32_t seq)
+{
+    uint32_t i = pos % CRC_QUEUE_LEN;
+
+    __atomic_store_n(&crcQueue.slot[i].seq, seq - i, __ATOMIC_RELEASE);
+}
+
+// Advance tail from *pos to *pos + 1, or set *pos to the new tail if
+//  another producer got there first.  Cortex-M0/M0+ have no exclusive loads
+//  and stores, and GCC would call __atomic_compare_exchange_4(), which
+//  arm-none-eabi toolchains don't provide; there it is done with interrupts
+//  masked for a few instructions, which is just as safe at any priority.
+static int crcTailClaim(uint32_t *pos)
+{
+#if defined(__ARM_ARCH_6M__)
+    uint32_t primask;
+    int claimed;
+
+    __asm__ volatile ("mrs %0, primask" : "=r" (primask));
+    __asm__ volatile ("cpsid i" ::: "memory");
+    claimed = (crcQueue.tail == *pos);
+    if (claimed)
+    {
+        crcQueue.tail = *pos + 1;
+    }
+    else
+    {
+        *pos = crcQueue.tail;
+    }
+    __asm__ volatile ("msr primask, %0" :: "r" (primask) : "memory");
+    return claimed;
+#else
+    return __atomic_compare_exchange_n(&crcQueue.tail, pos, *pos + 1, 1,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#endif
+}
+
+int crcQueuePost(const CrcJob *job)
+{
+    uint32_t pos = __atomic_load_n(&crcQueue.tail, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        uint32_t seq = crcSeqLoad(pos);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0)
+        {
+            if (crcTailClaim(&pos))
+            {
+                break;
+            }
+            // pos now holds the new tail
+        }
+        else if (diff < 0)
+        {
+            return -1;          // the consumer hasn't emptied this slot yet
+        }
+        else
+        {
+            pos = __atomic_load_n(&crcQueue.tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    crcQueue.slot[pos % CRC_QUEUE_LEN].job = *job;
+    crcSeqStore(pos, pos + 1);
+
+    crcPortQueueKick();
+    return 0;
+}
+
+// Take the next job out of the ring into crcQueue.job.  Returns 0 if there
+//  isn't one.
+static int crcQueuePop(void)
+{
+    uint32_t pos = crcQueue.head;
+
+    if (crcSeqLoad(pos) != pos + 1)
+    {
+        return 0;
+    }
+
+    crcQueue.job = crcQueue.slot[pos % CRC_QUEUE_LEN].job;
+    crcSeqStore(pos, pos + CRC_QUEUE_LEN);
+    crcQueue.head = pos + 1;
+    return 1;
+}
+
+static void crcQueueFinish(void)
+{
+    uint32_t crc = crcFinal(&crcQueue.ctx);
+
+    crcQueue.job.done(crc, crcQueue.job.arg);
+}
+
+#if CRC_QUEUE_DMA
+
+static void crcQueueDmaDone(CrcCtx *ctx, void *arg)
+{
+    (void)ctx;
+    (void)arg;
+
+    crcQueue.running = 0;
+    if (!crcQueue.inService)
+    {
+        // From the DMA interrupt: finish this job and start the next
+        crcQueueFinish();
+        crcQueueService();
+    }
+}
+
+void crcQueueService(void)
+{
+    if (crcQueue.running)
+    {
+        return;                 // crcQueueDmaDone() will carry on
+    }
+
+    while (crcQueuePop())
+    {
+        crcInit(&crcQueue.ctx, crcQueue.job.initValue, crcQueue.job.order);
+
+        crcQueue.running = 1;
+        crcQueue.inService = 1;
+        crcUpdateDma(&crcQueue.ctx, crcQueue.job.data, crcQueue.job.len, crcQueueDmaDone, NULL);
+        crcQueue.inService = 0;
+
+        if (crcQueue.running)
+        {
+            return;             // waiting for the DMA
+        }
+        crcQueueFinish();       // too short for DMA, so already done
+    }
+}
+
+#else
+
+void crcQueueService(void)
+{
+    while (crcQueuePop())
+    {
+        crcInit(&crcQueue.ctx, crcQueue.job.initValue, crcQueue.job.order);
+        crcUpdate(&crcQueue.ctx, crcQueue.job.data, crcQueue.job.len);
+        crcQueueFinish();
+    }
+}
+
+#endif
@@ -0,0 +1,81 @@
+// crc_queue.h
+//
+// A queue of CRC jobs, for interrupt handlers (UART, CAN, USB, ...) that
+// want CRCs of their frames but can't wait for the peripheral.
+//
+// Producers post jobs into a fixed ring of CRC_QUEUE_LEN slots without
+// taking a lock, so they can be at any interrupt priority and preempt each
+// other.  A single service, crcQueueService(), takes the jobs out in order,
+// calculates each CRC with crcInit()/crcUpdate() (so any initial value,
+// alignment and order work) and calls the job's done function with it.
+//
+// The service owns the peripheral: nothing else may use it while jobs are
+// queued.  The application provides crcPortQueueKick(), which makes
+// crcQueueService() run soon, e.g. by pending a low-priority interrupt (or
+// PendSV) whose handler calls it.
+//
+// With CRC_QUEUE_DMA set to 1, jobs are fed with crcUpdateDma() and the
+// service carries on from the DMA callback; the DMA interrupt and the
+// service's interrupt must then be at the same priority.
+//
+// The ring uses per-slot sequence numbers, so producers only contend on one
+// compare-and-swap.  It needs the GCC __atomic builtins.  Cortex-M0/M0+
+// have no exclusive loads and stores, so there the compare-and-swap is done
+// with interrupts masked for a few instructions (PRIMASK is saved and put
+// back); nothing from libatomic is needed, and posting is still safe at any
+// interrupt priority.
+
+#ifndef CRC_QUEUE_H
+#define CRC_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of slots in the ring; a power of 2
+#ifndef CRC_QUEUE_LEN
+#define CRC_QUEUE_LEN 16u
+#endif
+
+#if (CRC_QUEUE_LEN & (CRC_QUEUE_LEN - 1)) != 0
+#error "CRC_QUEUE_LEN must be a power of 2"
+#endif
+
+#ifndef CRC_QUEUE_DMA
+#define CRC_QUEUE_DMA 0
+#endif
+
+// Called from the service's context with the CRC of a job's data
+typedef void (*CrcJobFn)(uint32_t crc, void *arg);
+
+typedef struct
+{
+    const void *data;           // must stay unchanged until done is called
+    size_t len;
+    uint32_t initValue;
+    CrcOrder order;
+    CrcJobFn done;
+    void *arg;
+} CrcJob;
+
+// Copy job into the queue and kick the service.  Safe to call from any
+//  interrupt.  Returns 0, or -1 if the queue is full.
+int crcQueuePost(const CrcJob *job);
+
+// Run jobs until the queue is empty (or, with CRC_QUEUE_DMA, until a job is
+//  waiting for the DMA).  Must only be called from one context.
+void crcQueueService(void);
+
+// Provided by the application: make crcQueueService() run soon
+void crcPortQueueKick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_QUEUE_H
@@ -0,0 +1,54 @@
+// crc_ref.c
+//
+// See crc_ref.h
+
+#include "crc_ref.h"
+
+uint32_t simpleCRC(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    uint32_t shiftReg = 0;
+
+    // The real data, then the 32 appended zero bits
+    for (size_t i = 0; i < len + 4; i++)
+    {
+        uint8_t byte = (i < len) ? p[i] : 0;
+
+        for (int bit = 7; bit >= 0; bit--)
+        {
+            // Save most-significant bit of shiftReg
+            uint32_t pop = shiftReg & 0x80000000u;
+
+            shiftReg <<= 1;
+            if (pop)
+            {
+                shiftReg ^= CRC_POLY;
+            }
+
+            shiftReg ^= (byte >> bit) & 1u;
+        }
+    }
+
+    return shiftReg;
+}
+
+uint32_t cleverCRC(uint32_t crcReg, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        for (int bit = 7; bit >= 0; bit--)
+        {
+            uint32_t popCrc = ((crcReg >> 31) & 1u) ^ ((p[i] >> bit) & 1u);
+
+            crcReg <<= 1;
+            if (popCrc)
+            {
+                crcReg ^= CRC_POLY;
+            }
+        }
+    }
+
+    return crcReg;
+}
@@ -0,0 +1,34 @@
+// crc_ref.h
+//
+// Reference bit-at-a-time CRC implementations; these are the simpleCRC() and
+// cleverCRC() pseudocode from stm32crc.adoc turned into real C.  They are
+// slow, and exist to check the faster code against.
+//
+// Data is processed in increasing address order, and each byte from most- to
+// least-significant bit, as in the "Start Address" and "End Address" examples.
+
+#ifndef CRC_REF_H
+#define CRC_REF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CRC_POLY 0x04C11DB7u
+
+// simpleCRC() with shiftReg initialised to zero, and the 32 zero bits
+//  appended to the data internally
+uint32_t simpleCRC(const void *data, size_t len);
+
+// cleverCRC() with crcReg initialised to the given value; pass 0xFFFFFFFF to
+//  get the same result as the basic CRC peripheral after a reset
+uint32_t cleverCRC(uint32_t crcReg, const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_REF_H
@@ -0,0 +1,129 @@
+// crc_reflect.c
+//
+// See crc_reflect.h.  The peripheral always works most-significant bit
+// first, so the reflected shift register is RBIT of the peripheral's.
+
+#include "crc_reflect.h"
+#include "stm32crc_int.h"
+#include "crc_port.h"
+#include "crc_stats.h"
+
+// n (1..3) bytes in increasing address order, each bit-reversed, in the
+//  least-significant bytes of the result
+static uint32_t crcGatherReflected(const uint8_t *p, unsigned n)
+{
+    uint32_t bits = 0;
+
+    for (unsigned i = n; i > 0; i--)
+    {
+        bits = (bits << 8) | p[i - 1];
+    }
+
+    return crcRbit(bits) >> (32 - 8 * n);
+}
+
+// Write words to the peripheral, four at a time: all four loads first (which
+//  the compiler can merge into an LDM), then the independent RBITs, then the
+//  stores to the data register
+static void crcFeedReflected(const CrcWord *w, size_t words)
+{
+    for (; words >= 4; words -= 4, w += 4)
+    {
+        uint32_t a = w[0];
+        uint32_t b = w[1];
+        uint32_t c = w[2];
+        uint32_t d = w[3];
+
+        a = crcRbit(a);
+        b = crcRbit(b);
+        c = crcRbit(c);
+        d = crcRbit(d);
+
+        CRC_HW_WRITE(a);
+        CRC_HW_WRITE(b);
+        CRC_HW_WRITE(c);
+        CRC_HW_WRITE(d);
+    }
+
+    for (; words > 0; words--, w++)
+    {
+        CRC_HW_WRITE(crcRbit(*w));
+    }
+}
+
+void crcInitReflected(CrcCtx *ctx, uint32_t initValue)
+{
+    CRC_HW_RESET();
+    ctx->pendXor = crcRbit(initValue) ^ 0xFFFFFFFFu;
+    ctx->carry = 0;
+    ctx->carryLen = 0;
+    ctx->tail = CRC_TAIL_PERIPHERAL;
+    ctx->order = CRC_ORDER_BYTES;
+}
+
+static void crcReflectFeed(CrcCtx *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    // "Start Address"
+    size_t head = (0u - (uintptr_t)p) & 3u;
+    if (head > len)
+    {
+        head = len;
+    }
+    if (head)
+    {
+        CRC_STATS_INC(heads);
+        crcPartial(ctx, crcGatherReflected(p, (unsigned)head), (unsigned)head);
+        p += head;
+        len -= head;
+    }
+
+    // The first whole word carries pendXor, the rest go straight in
+    size_t words = len / 4;
+    if (words)
+    {
+        const CrcWord *w = (const CrcWord *)p;
+
+        CRC_HW_WRITE(crcRbit(*w) ^ ctx->pendXor);
+        ctx->pendXor = 0;
+        crcFeedReflected(w + 1, words - 1);
+        CRC_STATS_INC(cpuFeeds);
+        p += words * 4;
+        len -= words * 4;
+    }
+
+    // "End Address"
+    if (len)
+    {
+        CRC_STATS_INC(tails);
+        crcPartial(ctx, crcGatherReflected(p, (unsigned)len), (unsigned)len);
+    }
+}
+
+void crcUpdateReflected(CrcCtx *ctx, const void *data, size_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+    CRC_STATS_START(start);
+    crcReflectFeed(ctx, data, len);
+    CRC_STATS_END(start, CRC_BACKEND_HW, len);
+}
+
+uint32_t crcFinalReflected(const CrcCtx *ctx)
+{
+    // Every head and tail was done by crcPartial(), so nothing is carried
+    return crcRbit(CRC_HW_READ() ^ ctx->pendXor);
+}
+
+uint32_t crc32Zlib(const void *data, size_t len)
+{
+    CrcCtx ctx;
+
+    crcInitReflected(&ctx, 0xFFFFFFFFu);
+    crcUpdateReflected(&ctx, data, len);
+    return crcFinalReflected(&ctx) ^ 0xFFFFFFFFu;
+}
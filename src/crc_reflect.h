@@ -0,0 +1,46 @@
+// crc_reflect.h
+//
+// Bit-reflected CRC-32 using the basic peripheral, as in "Reversing Bit
+// Order": bytes are processed in increasing address order, and each byte
+// from least- to most-significant bit.  With initial value and final XOR
+// 0xFFFFFFFF this is the standard CRC-32 used by zlib and Ethernet.
+//
+// RBIT of a word read from memory puts the least-significant bit of its
+// lowest-addressed byte first, so each word needs only RBIT, no REV.  The
+// words are fed four at a time so the bit reversals can overlap.  Cortex-M0
+// and M0+ have no RBIT, and reverse the bits a nibble at a time instead.
+//
+// A CrcCtx started with crcInitReflected() must only be used with the other
+// functions here.  As with stm32crc.h, only one CrcCtx may be in use at a
+// time.
+
+#ifndef CRC_REFLECT_H
+#define CRC_REFLECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Reset the peripheral and start a new reflected CRC.  initValue is the
+//  reflected shift register's initial value (0xFFFFFFFF for zlib).
+void crcInitReflected(CrcCtx *ctx, uint32_t initValue);
+
+// Feed len bytes of data, at any alignment, into the CRC
+void crcUpdateReflected(CrcCtx *ctx, const void *data, size_t len);
+
+// The reflected shift register; XOR with 0xFFFFFFFF for the zlib CRC
+uint32_t crcFinalReflected(const CrcCtx *ctx);
+
+// The standard (zlib, Ethernet) CRC-32 of the data
+uint32_t crc32Zlib(const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_REFLECT_H
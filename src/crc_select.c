@@ -0,0 +1,232 @@
+// crc_select.c
+//
+// See crc_select.h
+
+#include "crc_select.h"
+#include "crc_poly.h"
+#include "crc_port.h"
+#include "crc_prog.h"
+#include "crc_ref.h"
+#include "crc_reflect.h"
+#include "crc_stats.h"
+#include "crc_sw.h"
+
+#if CRC_SELECT_DMA
+#include "crc_dma.h"
+#endif
+
+// Reflected CRC-32 table, built by crcSelectInitReflected()
+static CrcPoly crcSelectZlib;
+
+uint32_t crcBackendHw(const void *data, size_t len, uint32_t crcReg, CrcOrder order)
+{
+    return crcCalc(data, len, crcReg, order);
+}
+
+uint32_t crcBackendSw(const void *data, size_t len, uint32_t crcReg, CrcOrder order)
+{
+    return crcSwUpdate(crcReg, data, len, order);
+}
+
+uint32_t crcBackendProg(const void *data, size_t len, uint32_t crcReg, CrcOrder order)
+{
+    CrcParams params = { 32, 0, 0, CRC_POLY, crcReg, 0 };
+
+    (void)order;
+    return crcProgCalc(&params, data, len);
+}
+
+#if CRC_SELECT_DMA
+static void crcSelectDmaDone(CrcCtx *ctx, void *arg)
+{
+    (void)ctx;
+    *(volatile int *)arg = 1;
+}
+
+uint32_t crcBackendDma(const void *data, size_t len, uint32_t crcReg, CrcOrder order)
+{
+    CrcCtx ctx;
+    volatile int done = 0;
+
+    crcInit(&ctx, crcReg, order);
+    crcUpdateDma(&ctx, data, len, crcSelectDmaDone, (void *)&done);
+    while (!done)
+    {
+    }
+    return crcFinal(&ctx);
+}
+#endif
+
+uint32_t crcBackendRbit(const void *data, size_t len, uint32_t crcReg, CrcOrder order)
+{
+    CrcCtx ctx;
+
+    (void)order;
+    crcInitReflected(&ctx, crcReg);
+    crcUpdateReflected(&ctx, data, len);
+    return crcFinalReflected(&ctx);
+}
+
+uint32_t crcBackendReflectSw(const void *data, size_t len, uint32_t crcReg, CrcOrder order)
+{
+    const uint8_t *p = data;
+
+    (void)order;
+    for (size_t i = 0; i < len; i++)
+    {
+        crcReg = (crcReg >> 8) ^ crcSelectZlib.table[(crcReg ^ p[i]) & 0xFFu];
+    }
+    return crcReg;
+}
+
+// The backends that can calculate sel's CRC; returns how many
+static unsigned crcSelectCandidates(const CrcSelect *sel, CrcBackendFn *fn)
+{
+    unsigned n = 0;
+
+    if (sel->reflected)
+    {
+        fn[n++] = crcBackendReflectSw;
+        fn[n++] = crcBackendRbit;
+        return n;
+    }
+
+    fn[n++] = crcBackendSw;
+    fn[n++] = crcBackendHw;
+    if (sel->order == CRC_ORDER_BYTES && (crcProgCaps() & CRC_CAP_INIT))
+    {
+        fn[n++] = crcBackendProg;
+    }
+#if CRC_SELECT_DMA
+    if (sel->order == CRC_ORDER_WORDS)
+    {
+        fn[n++] = crcBackendDma;
+    }
+#endif
+    return n;
+}
+
+static void crcSelectAdd(CrcSelect *sel, size_t minLen, CrcBackendFn fn)
+{
+    if (sel->steps && sel->step[sel->steps - 1].fn == fn)
+    {
+        return;
+    }
+    if (sel->steps == CRC_SELECT_MAX)
+    {
+        return;                 // the last step carries on to any length
+    }
+    sel->step[sel->steps].minLen = minLen;
+    sel->step[sel->steps].fn = fn;
+    sel->steps++;
+}
+
+void crcSelectInit(CrcSelect *sel, CrcOrder order)
+{
+    sel->order = order;
+    sel->reflected = 0;
+    sel->steps = 0;
+
+    crcSelectAdd(sel, 0, crcBackendSw);
+    if (order == CRC_ORDER_BYTES && (crcProgCaps() & CRC_CAP_INIT))
+    {
+        crcSelectAdd(sel, CRC_SELECT_SW_BELOW, crcBackendProg);
+    }
+    else
+    {
+        crcSelectAdd(sel, CRC_SELECT_SW_BELOW, crcBackendHw);
+    }
+#if CRC_SELECT_DMA
+    if (order == CRC_ORDER_WORDS)
+    {
+        crcSelectAdd(sel, CRC_SELECT_DMA_FROM, crcBackendDma);
+    }
+#endif
+}
+
+void crcSelectInitReflected(CrcSelect *sel)
+{
+    crcPolyInit(&crcSelectZlib, &crcParamsCrc32);
+
+    sel->order = CRC_ORDER_BYTES;
+    sel->reflected = 1;
+    sel->steps = 0;
+
+    // Without RBIT, reversing each word a nibble at a time costs more than
+    //  the table lookups it saves
+    crcSelectAdd(sel, 0, crcBackendReflectSw);
+#if CRC_HAVE_RBIT
+    crcSelectAdd(sel, CRC_SELECT_SW_BELOW, crcBackendRbit);
+#endif
+}
+
+static uint32_t crcSelectTime(CrcBackendFn fn, const void *data, size_t len, CrcOrder order)
+{
+    uint32_t best = 0xFFFFFFFFu;
+
+    // The best of three, so an interrupt doesn't spoil it
+    for (int i = 0; i < 3; i++)
+    {
+        uint32_t start = CRC_STATS_CYCLES();
+        fn(data, len, 0xFFFFFFFFu, order);
+        uint32_t cycles = CRC_STATS_CYCLES() - start;
+        if (cycles < best)
+        {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+int crcSelectProbe(CrcSelect *sel, const void *scratch, size_t len)
+{
+    CrcBackendFn fn[4];
+    unsigned n = crcSelectCandidates(sel, fn);
+
+    if (len < 4)
+    {
+        return -1;
+    }
+
+    // Each winner takes over from halfway (on a log scale) between the
+    //  length it won at and the one before
+    sel->steps = 0;
+    for (size_t at = 4; at <= len; at *= 4)
+    {
+        unsigned win = 0;
+        uint32_t winCycles = 0xFFFFFFFFu;
+        for (unsigned i = 0; i < n; i++)
+        {
+            uint32_t cycles = crcSelectTime(fn[i], scratch, at, sel->order);
+            if (cycles < winCycles)
+            {
+                win = i;
+                winCycles = cycles;
+            }
+        }
+        crcSelectAdd(sel, sel->steps ? at / 2 : 0, fn[win]);
+    }
+    return 0;
+}
+
+int crcSelectSet(CrcSelect *sel, const CrcSelectStep *step, unsigned count)
+{
+    if (count == 0 || count > CRC_SELECT_MAX || step[0].minLen != 0)
+    {
+        return -1;
+    }
+    for (unsigned i = 0; i < count; i++)
+    {
+        if (!step[i].fn || (i && step[i].minLen <= step[i - 1].minLen))
+        {
+            return -1;
+        }
+    }
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        sel->step[i] = step[i];
+    }
+    sel->steps = (uint8_t)count;
+    return 0;
+}
@@ -0,0 +1,134 @@
+// crc_select.h
+//
+// Picking the fastest way to calculate a CRC for each buffer length.
+//
+// Which path wins depends on the part: the peripheral's per-call cost (the
+// reset and the "End Address" read-back) makes the software table faster
+// for short buffers; DMA only pays for itself on long ones; the "more
+// capable" peripheral takes unaligned bytes without any read-back; and
+// Cortex-M0/M0+ have no RBIT ("Builtins"), so a table can beat the
+// peripheral for reflected CRCs.  A CrcSelect holds a short table of
+// length thresholds, each with a backend, and crcSelectUpdate() looks up
+// the length and makes one indirect call.
+//
+// The table can be filled in three ways:
+//  - crcSelectInit() / crcSelectInitReflected(): defaults from what the
+//    core and crcProgCaps() say, without timing anything (the peripheral
+//    is only probed by the first crcProgCaps(), so make that at startup);
+//  - crcSelectProbe(): time every backend available at a few lengths, at
+//    startup, with CRC_STATS_CYCLES() (see crc_stats.h);
+//  - crcSelectSet(): a table written from bench/crc_bench.c results.
+//    hw_bytes/hw_words/hw_halfwords are crcBackendHw, sw_slice* is
+//    crcBackendSw, hw_dma is crcBackendDma, hw_reflected is crcBackendRbit.
+//
+// Every backend takes and returns the shift register value, so a CRC can be
+// continued from one call to the next even if they use different backends.
+// The peripheral backends reset it, so nothing else may be using it.
+
+#ifndef CRC_SELECT_H
+#define CRC_SELECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Most thresholds in one table
+#ifndef CRC_SELECT_MAX
+#define CRC_SELECT_MAX 6u
+#endif
+
+// Set to 1 to include crcBackendDma (needs crcPortDmaStart())
+#ifndef CRC_SELECT_DMA
+#define CRC_SELECT_DMA 0
+#endif
+
+// Defaults for crcSelectInit(): the table below this many bytes, DMA from
+//  this many
+#ifndef CRC_SELECT_SW_BELOW
+#define CRC_SELECT_SW_BELOW 8u
+#endif
+
+#ifndef CRC_SELECT_DMA_FROM
+#define CRC_SELECT_DMA_FROM 1024u
+#endif
+
+// crcReg after len bytes of data, starting from crcReg.  For reflected
+//  CRCs crcReg is the reflected shift register, as for crcInitReflected().
+typedef uint32_t (*CrcBackendFn)(const void *data, size_t len, uint32_t crcReg, CrcOrder order);
+
+// The peripheral fed by the CPU (crcCalc())
+uint32_t crcBackendHw(const void *data, size_t len, uint32_t crcReg, CrcOrder order);
+
+// crcSwUpdate()
+uint32_t crcBackendSw(const void *data, size_t len, uint32_t crcReg, CrcOrder order);
+
+// The "more capable" peripheral with INIT and 8/16-bit writes; for
+//  CRC_ORDER_BYTES only
+uint32_t crcBackendProg(const void *data, size_t len, uint32_t crcReg, CrcOrder order);
+
+#if CRC_SELECT_DMA
+// crcUpdateDma(), waiting for it to finish; the DMA interrupt must be able
+//  to run
+uint32_t crcBackendDma(const void *data, size_t len, uint32_t crcReg, CrcOrder order);
+#endif
+
+// Reflected CRC-32: the peripheral with RBIT (crc_reflect.h), or a table
+uint32_t crcBackendRbit(const void *data, size_t len, uint32_t crcReg, CrcOrder order);
+uint32_t crcBackendReflectSw(const void *data, size_t len, uint32_t crcReg, CrcOrder order);
+
+// Use fn for lengths from minLen up to the next step's minLen
+typedef struct
+{
+    size_t minLen;
+    CrcBackendFn fn;
+} CrcSelectStep;
+
+typedef struct
+{
+    CrcOrder order;
+    uint8_t reflected;
+    uint8_t steps;
+    CrcSelectStep step[CRC_SELECT_MAX];     // increasing minLen, the first 0
+} CrcSelect;
+
+// Defaults for the CRC the peripheral calculates, in the given order
+void crcSelectInit(CrcSelect *sel, CrcOrder order);
+
+// Defaults for the reflected (zlib) CRC-32
+void crcSelectInitReflected(CrcSelect *sel);
+
+// Time each backend that can do sel's CRC on 4, 16, 64, ... bytes (up to
+//  len) at scratch, and keep the fastest for each length.  sel must have
+//  been set up by one of the above, which says which CRC it is for.  Needs
+//  CRC_STATS_CYCLES() running.  It runs the peripheral backends, so
+//  nothing else may be using the peripheral.  Returns 0, or -1 if len < 4.
+int crcSelectProbe(CrcSelect *sel, const void *scratch, size_t len);
+
+// Use the given steps (increasing minLen, the first 0) instead, after one
+//  of the above.  Returns 0, or -1 if they aren't valid, leaving sel
+//  unchanged.
+int crcSelectSet(CrcSelect *sel, const CrcSelectStep *step, unsigned count);
+
+// crcReg after len bytes of data, by whichever backend sel has for len
+static inline uint32_t crcSelectUpdate(const CrcSelect *sel, uint32_t crcReg,
+                                       const void *data, size_t len)
+{
+    const CrcSelectStep *s = &sel->step[sel->steps - 1];
+
+    while (len < s->minLen)
+    {
+        s--;
+    }
+    return s->fn(data, len, crcReg, sel->order);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_SELECT_H
@@ -0,0 +1,106 @@
+// crc_share.c
+//
+// See crc_share.h.
+//
+// A stream that doesn't hold the peripheral keeps its CRC in pendXor in the
+// form crcInit() would leave it: CRC ^ 0xFFFFFFFF.  Resuming it is then just
+// a reset of the peripheral.
+
+#include "crc_share.h"
+#include "crc_port.h"
+#include "crc_stats.h"
+
+// The stream whose CRC is in the peripheral, if any
+static CrcCtx *crcOwner;
+
+// Save the owner's CRC, if another stream holds the peripheral, and give
+//  ctx the peripheral.  Called with the lock held.
+static void crcTakeOver(CrcCtx *ctx)
+{
+    if (crcOwner == ctx)
+    {
+        return;
+    }
+
+    if (crcOwner)
+    {
+        crcOwner->pendXor ^= CRC_HW_READ() ^ 0xFFFFFFFFu;
+    }
+    CRC_HW_RESET();
+    crcOwner = ctx;
+}
+
+// Let go of the peripheral, keeping the CRC in ctx.  Called with the lock
+//  held.
+static void crcGiveUp(CrcCtx *ctx)
+{
+    if (crcOwner == ctx)
+    {
+        ctx->pendXor ^= CRC_HW_READ() ^ 0xFFFFFFFFu;
+        crcOwner = NULL;
+    }
+}
+
+// crcPortLock(), timed for crcStats
+static void crcShareLock(void)
+{
+#if CRC_STATS
+    uint32_t start = CRC_STATS_CYCLES();
+    crcPortLock();
+    crcStatsLockWait(CRC_STATS_CYCLES() - start);
+#else
+    crcPortLock();
+#endif
+}
+
+void crcSharedInit(CrcCtx *ctx, uint32_t initValue, CrcOrder order)
+{
+    // A stream being restarted may still hold the peripheral; it has to
+    //  come back in through crcTakeOver() so the new initial value is used
+    crcShareLock();
+    if (crcOwner == ctx)
+    {
+        crcOwner = NULL;
+    }
+    ctx->pendXor = initValue ^ 0xFFFFFFFFu;
+    ctx->carry = 0;
+    ctx->carryLen = 0;
+    ctx->tail = CRC_TAIL_PERIPHERAL;
+    ctx->order = order;
+    crcPortUnlock();
+}
+
+void crcSharedUpdate(CrcCtx *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    while (len)
+    {
+        // End each chunk on a word boundary, so CRC_ORDER_WORDS gives the
+        //  same result as a single crcUpdate()
+        size_t n = len;
+        if (n > CRC_SHARE_CHUNK)
+        {
+            n = CRC_SHARE_CHUNK - ((uintptr_t)(p + CRC_SHARE_CHUNK) & 3u);
+        }
+
+        crcShareLock();
+        crcTakeOver(ctx);
+        crcUpdate(ctx, p, n);
+        crcPortUnlock();
+
+        p += n;
+        len -= n;
+    }
+}
+
+uint32_t crcSharedFinal(CrcCtx *ctx)
+{
+    crcShareLock();
+    crcTakeOver(ctx);
+    uint32_t crc = crcFinal(ctx);
+    crcGiveUp(ctx);
+    crcPortUnlock();
+
+    return crc;
+}
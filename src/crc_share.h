@@ -0,0 +1,56 @@
+// crc_share.h
+//
+// Several CRC streams sharing the one peripheral, e.g. from different RTOS
+// tasks.
+//
+// The peripheral holds the CRC of whichever stream used it last.  When
+// another stream wants it, the first stream's CRC is read out and kept in
+// its CrcCtx, and the new stream's CRC is put back using "Changing the
+// Initial Value": reset the peripheral and XOR the saved CRC (and
+// 0xFFFFFFFF) into the stream's next data word.  Saving costs one read and
+// resuming costs one reset, so streams can take turns at word granularity.
+//
+// The peripheral lock is only held while one chunk of at most
+// CRC_SHARE_CHUNK bytes is fed in, so a long CRC doesn't hold up the others.
+//
+// Every use of the peripheral must go through these functions while any
+// shared stream is in progress.  The application provides crcPortLock()
+// and crcPortUnlock(), e.g. using an RTOS mutex.
+
+#ifndef CRC_SHARE_H
+#define CRC_SHARE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CRC_SHARE_CHUNK
+#define CRC_SHARE_CHUNK 256u
+#endif
+
+// Start a new stream.  Doesn't touch the peripheral.
+void crcSharedInit(CrcCtx *ctx, uint32_t initValue, CrcOrder order);
+
+// Feed len bytes of data, at any alignment, into the stream
+void crcSharedUpdate(CrcCtx *ctx, const void *data, size_t len);
+
+// The CRC of all the data fed into the stream so far.  Afterwards the
+//  stream no longer holds the peripheral, so ctx may be discarded, or the
+//  stream continued with more crcSharedUpdate() calls.
+uint32_t crcSharedFinal(CrcCtx *ctx);
+
+// Provided by the application: take and give back exclusive use of the
+//  peripheral
+void crcPortLock(void);
+void crcPortUnlock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_SHARE_H
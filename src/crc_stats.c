@@ -0,0 +1,48 @@
+// crc_stats.c
+//
+// See crc_stats.h
+
+#include <string.h>
+
+#include "crc_stats.h"
+
+CrcStats crcStats;
+
+void crcStatsRead(CrcStats *out)
+{
+    memcpy(out, &crcStats, sizeof *out);
+}
+
+void crcStatsClear(void)
+{
+    memset(&crcStats, 0, sizeof crcStats);
+}
+
+// floor(log2(cycles)), with 0 in bin 0 and the top bin open-ended
+static unsigned crcStatsBin(uint32_t cycles)
+{
+    unsigned bin = 0;
+
+    while (cycles > 1 && bin < CRC_STATS_BINS - 1)
+    {
+        cycles >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+void crcStatsAdd(CrcBackend backend, size_t len, uint32_t cycles)
+{
+    crcStats.bytes[backend] += (uint32_t)len;
+    crcStats.cycles[backend][crcStatsBin(cycles)]++;
+}
+
+void crcStatsLockWait(uint32_t cycles)
+{
+    crcStats.lockWaits++;
+    crcStats.lockWaitCycles += cycles;
+    if (cycles > crcStats.lockWaitMax)
+    {
+        crcStats.lockWaitMax = cycles;
+    }
+}
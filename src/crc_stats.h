@@ -0,0 +1,98 @@
+// crc_stats.h
+//
+// Counters in the CRC drivers, for finding out in the field how much time
+// goes to CRCs and how often the slow paths run.  Build everything with
+// -DCRC_STATS=1 to turn them on; with the default of 0 they compile to
+// nothing.
+//
+// The counters live in one CrcStats struct, crcStats, which can be read
+// (e.g. by a telemetry task) with crcStatsRead().  They are plain 32-bit
+// counters that wrap, so take differences between readings.  Updates
+// aren't atomic: if CRCs run at more than one interrupt priority, a count
+// can occasionally be lost.
+//
+// Time is measured with CRC_STATS_CYCLES(), by default the DWT cycle
+// counter, which the application must enable (DEMCR.TRCENA and
+// DWT_CTRL.CYCCNTENA).  Cortex-M0/M0+ have no DWT, so define it there, e.g.
+// from a free-running timer; crc_sim.h defines it for host builds.  Each
+// timed call adds to a histogram bin for its backend: bin i counts calls
+// that took 2^i to 2^(i + 1) - 1 cycles; the last bin also takes anything
+// longer.
+
+#ifndef CRC_STATS_H
+#define CRC_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crc_port.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CRC_STATS
+#define CRC_STATS 0
+#endif
+
+#ifndef CRC_STATS_BINS
+#define CRC_STATS_BINS 16u
+#endif
+
+#ifndef CRC_STATS_CYCLES
+#define CRC_STATS_CYCLES() (*(volatile uint32_t *)0xE0001004u)    // DWT_CYCCNT
+#endif
+
+typedef enum
+{
+    CRC_BACKEND_HW,             // crcUpdate() and crcUpdateReflected()
+    CRC_BACKEND_DMA,            // whole words fed by crcUpdateDma()
+    CRC_BACKEND_SW,             // crcSwUpdate() and crcPolySwCalc()
+    CRC_BACKEND_PROG,           // crcProgUpdate()
+    CRC_BACKEND_COUNT
+} CrcBackend;
+
+typedef struct
+{
+    uint32_t bytes[CRC_BACKEND_COUNT];
+
+    uint32_t heads;             // "Start Address" fixups
+    uint32_t tails;             // "End Address" fixups
+    uint32_t cpuFeeds;          // runs of whole words written by the CPU
+    uint32_t dmaFeeds;          // DMA transfers started
+
+    // crcPortLock() calls from crc_share.c, and the cycles spent in them
+    uint32_t lockWaits;
+    uint32_t lockWaitCycles;
+    uint32_t lockWaitMax;
+
+    // Cycles per call; for DMA, from crcUpdateDma() to the done callback
+    uint32_t cycles[CRC_BACKEND_COUNT][CRC_STATS_BINS];
+} CrcStats;
+
+extern CrcStats crcStats;
+
+// Copy the counters out, or zero them
+void crcStatsRead(CrcStats *out);
+void crcStatsClear(void);
+
+// For the drivers: count one call of len bytes that took the given cycles,
+//  and one crcPortLock() wait
+void crcStatsAdd(CrcBackend backend, size_t len, uint32_t cycles);
+void crcStatsLockWait(uint32_t cycles);
+
+#if CRC_STATS
+#define CRC_STATS_INC(field)            (crcStats.field++)
+#define CRC_STATS_START(t)              uint32_t t = CRC_STATS_CYCLES()
+#define CRC_STATS_END(t, backend, len)  crcStatsAdd((backend), (len), CRC_STATS_CYCLES() - (t))
+#else
+#define CRC_STATS_INC(field)            ((void)0)
+#define CRC_STATS_START(t)
+#define CRC_STATS_END(t, backend, len)  ((void)0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_STATS_H
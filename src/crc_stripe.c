@@ -0,0 +1,131 @@
+// crc_stripe.c
+//
+// See crc_stripe.h.
+
+#include "crc_stripe.h"
+#include "crc_combine.h"
+#include "crc_sw.h"
+
+static unsigned crcStripeWeight(const CrcStripe *s)
+{
+    return s->weight ? s->weight : 1u;
+}
+
+// A cut at to, moved back to a word boundary but not before from
+static size_t crcStripeCut(const uint8_t *p, size_t from, size_t to)
+{
+    size_t over = (uintptr_t)(p + to) & 3u;
+
+    return (to - from >= over) ? to - over : from;
+}
+
+static void crcStripeDone(CrcStripe *s, uint32_t crc)
+{
+    s->crc = crc;
+    __atomic_store_n(&s->done, 1, __ATOMIC_RELEASE);
+}
+
+void crcStripeRun(CrcStripe *s)
+{
+    crcStripeDone(s, crcCalc(s->data, s->len, s->initValue, s->order));
+}
+
+void crcStripeRunSw(CrcStripe *s)
+{
+    crcStripeDone(s, crcStripeCalcSw(s->data, s->len, s->initValue, s->order));
+}
+
+uint32_t crcStripeCalc(CrcStripe *stripe, unsigned n, const void *data, size_t len,
+                       uint32_t initValue, CrcOrder order)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    if (n <= 1 || len < CRC_STRIPE_MIN)
+    {
+        return crcCalc(p, len, initValue, order);
+    }
+
+    uint32_t total = 0;
+    for (unsigned k = 0; k < n; k++)
+    {
+        total += crcStripeWeight(&stripe[k]);
+    }
+
+    // Cut at word boundaries in proportion to the weights; the last stripe
+    //  takes whatever is left
+    uint32_t sum = 0;
+    size_t from = 0;
+    for (unsigned k = 0; k < n; k++)
+    {
+        size_t to = len;
+        if (k < n - 1)
+        {
+            sum += crcStripeWeight(&stripe[k]);
+            to = crcStripeCut(p, from, (size_t)((uint64_t)len * sum / total));
+        }
+
+        stripe[k].data = p + from;
+        stripe[k].len = to - from;
+        stripe[k].initValue = k ? 0 : initValue;
+        stripe[k].order = order;
+        stripe[k].crc = 0;
+        stripe[k].done = 0;
+        from = to;
+    }
+
+    for (unsigned k = 1; k < n; k++)
+    {
+        if (stripe[k].len)
+        {
+            crcPortStripeStart(k, &stripe[k]);
+        }
+        else
+        {
+            stripe[k].done = 1;
+        }
+    }
+
+    crcStripeRun(&stripe[0]);
+    uint32_t crc = stripe[0].crc;
+
+    for (unsigned k = 1; k < n; k++)
+    {
+        while (!__atomic_load_n(&stripe[k].done, __ATOMIC_ACQUIRE))
+        {
+        }
+        crc = crcShift(crc, stripe[k].len) ^ stripe[k].crc;
+    }
+    return crc;
+}
+
+uint32_t crcStripeCalcSw(const void *data, size_t len, uint32_t initValue, CrcOrder order)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    if (len < CRC_STRIPE_MIN)
+    {
+        return crcSwCalc(p, len, initValue, order);
+    }
+
+    CrcSwStream s[CRC_SW_STREAMS];
+    size_t from = 0;
+    for (unsigned k = 0; k < CRC_SW_STREAMS; k++)
+    {
+        size_t to = (k < CRC_SW_STREAMS - 1) ? crcStripeCut(p, from, len / CRC_SW_STREAMS * (k + 1))
+                                             : len;
+
+        s[k].data = p + from;
+        s[k].len = to - from;
+        s[k].crcReg = k ? 0 : initValue;
+        from = to;
+    }
+
+    crcSwUpdateStreams(s, CRC_SW_STREAMS, order);
+
+    uint32_t crc = s[0].crcReg;
+    for (unsigned k = 1; k < CRC_SW_STREAMS; k++)
+    {
+        crc = crcShift(crc, s[k].len) ^ s[k].crcReg;
+    }
+    return crc;
+}
@@ -0,0 +1,85 @@
+// crc_stripe.h
+//
+// Calculating the CRC of a large buffer on several engines at once, e.g. the
+// CRC peripheral on each core of a dual-core STM32H7, or the peripheral on
+// one core and the software table on the other.
+//
+// The buffer is split into stripes at word boundaries, so only the first
+// stripe has a "Start Address" head and only the last has an "End Address"
+// tail.  The first stripe uses the initial value and runs on the calling
+// core; the others start from zero on the other engines.  Their CRCs are
+// then joined in order with crcShift() (see crc_combine.h):
+//
+//     crc = crcShift(crc, stripe[k].len) ^ stripe[k].crc
+//
+// The application provides crcPortStripeStart(), which hands a stripe to
+// engine k (1 to n - 1), where crcStripeRun() or crcStripeRunSw() must be
+// called on it.  The caller spins until every stripe is done, so engine k
+// must not need the caller's core to make progress.
+//
+// Both cores must see the same stripe array and data: on a Cortex-M7 with
+// the data cache on, put the CrcStripe array in non-cacheable memory and
+// clean the buffer from the cache first.  Completion uses the GCC __atomic
+// builtins.
+
+#ifndef CRC_STRIPE_H
+#define CRC_STRIPE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Buffers shorter than this are done on the calling core alone
+#ifndef CRC_STRIPE_MIN
+#define CRC_STRIPE_MIN 1024u
+#endif
+
+typedef struct
+{
+    // Set by the caller before crcStripeCalc(): this engine's relative
+    //  speed, so that e.g. a software engine can be given less data.  0
+    //  counts as 1.
+    unsigned weight;
+
+    // Set by crcStripeCalc() for the engine
+    const void *data;
+    size_t len;
+    uint32_t initValue;
+    CrcOrder order;
+
+    // Set by the engine
+    uint32_t crc;
+    int done;
+} CrcStripe;
+
+// The CRC of len bytes of data, at any alignment, split across n engines
+//  (stripe[0] being the calling core, which must own the peripheral).
+//  n == 1 is the same as crcCalc().
+uint32_t crcStripeCalc(CrcStripe *stripe, unsigned n, const void *data, size_t len,
+                       uint32_t initValue, CrcOrder order);
+
+// Called on engine k to process a stripe with that core's peripheral, or
+//  in software with crcStripeCalcSw()
+void crcStripeRun(CrcStripe *s);
+void crcStripeRunSw(CrcStripe *s);
+
+// The CRC of len bytes of data on the calling core alone, by software: the
+//  buffer is split into CRC_SW_STREAMS stripes as above, fed interleaved by
+//  crcSwUpdateStreams() (see crc_sw.h), and joined.  Doesn't use the
+//  peripheral, so e.g. a single-core M7 can run it on one buffer while DMA
+//  feeds the peripheral another.
+uint32_t crcStripeCalcSw(const void *data, size_t len, uint32_t initValue, CrcOrder order);
+
+// Provided by the application: make engine k (1 to n - 1) run s
+void crcPortStripeStart(unsigned k, CrcStripe *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_STRIPE_H
@@ -0,0 +1,319 @@
+// crc_sw.c
+//
+// See crc_sw.h
+
+#include "crc_sw.h"
+#include "crc_port.h"
+#include "crc_stats.h"
+
+// One 32-bit word, most-significant bit first, like the peripheral
+static inline uint32_t crcSwWord(uint32_t crcReg, uint32_t word)
+{
+    uint32_t x = crcReg ^ word;
+
+#if CRC_SW_SLICE == 0
+    // Branchless, unlike cleverCRC(): the top nibble picks the XOR of the
+    //  polynomial shifts it would have done
+    for (int i = 0; i < 8; i++)
+    {
+        x = (x << 4) ^ crcSwNibble[x >> 28];
+    }
+    return x;
+#elif CRC_SW_SLICE == 1
+    x = (x << 8) ^ crcSwTable[0][x >> 24];
+    x = (x << 8) ^ crcSwTable[0][x >> 24];
+    x = (x << 8) ^ crcSwTable[0][x >> 24];
+    x = (x << 8) ^ crcSwTable[0][x >> 24];
+    return x;
+#else
+    return crcSwTable[3][x >> 24]
+         ^ crcSwTable[2][(x >> 16) & 0xFF]
+         ^ crcSwTable[1][(x >> 8) & 0xFF]
+         ^ crcSwTable[0][x & 0xFF];
+#endif
+}
+
+#if CRC_SW_SLICE == 8
+// Two words; the first one's bytes are each followed by 4 more bytes than
+//  the second one's, so use tables 4-7 for it
+static inline uint32_t crcSwWord2(uint32_t crcReg, uint32_t word0, uint32_t word1)
+{
+    uint32_t x = crcReg ^ word0;
+
+    return crcSwTable[7][x >> 24]
+         ^ crcSwTable[6][(x >> 16) & 0xFF]
+         ^ crcSwTable[5][(x >> 8) & 0xFF]
+         ^ crcSwTable[4][x & 0xFF]
+         ^ crcSwTable[3][word1 >> 24]
+         ^ crcSwTable[2][(word1 >> 16) & 0xFF]
+         ^ crcSwTable[1][(word1 >> 8) & 0xFF]
+         ^ crcSwTable[0][word1 & 0xFF];
+}
+#endif
+
+// Up to 3 bytes, all within one memory word
+static uint32_t crcSwPartial(uint32_t crcReg, const uint8_t *p, size_t n, CrcOrder order)
+{
+    if (order == CRC_ORDER_BYTES)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            crcReg = crcSwByte(crcReg, p[i]);
+        }
+    }
+    else if (order == CRC_ORDER_HALFWORDS)
+    {
+        // Each halfword's bytes from the higher address down; the last
+        //  byte of a word starting on an odd address is on its own
+        size_t i = 0;
+        if (n && ((uintptr_t)p & 1u))
+        {
+            crcReg = crcSwByte(crcReg, p[i++]);
+        }
+        for (; i + 2 <= n; i += 2)
+        {
+            crcReg = crcSwByte(crcReg, p[i + 1]);
+            crcReg = crcSwByte(crcReg, p[i]);
+        }
+        if (i < n)
+        {
+            crcReg = crcSwByte(crcReg, p[i]);
+        }
+    }
+    else
+    {
+        for (size_t i = n; i > 0; i--)
+        {
+            crcReg = crcSwByte(crcReg, p[i - 1]);
+        }
+    }
+
+    return crcReg;
+}
+
+// One word, as loaded from memory, in most-significant-byte-first
+//  processing order
+static inline uint32_t crcSwOrderWord(uint32_t w, CrcOrder order)
+{
+    switch (order)
+    {
+    case CRC_ORDER_BYTES:
+        return crcRev(w);
+    case CRC_ORDER_HALFWORDS:
+        return crcRor16(w);
+    default:
+        return w;
+    }
+}
+
+// Whole, aligned words
+static inline uint32_t crcSwWords(uint32_t crcReg, const CrcWord *w, size_t words, CrcOrder order)
+{
+#if CRC_SW_SLICE == 8
+    for (; words >= 2; words -= 2, w += 2)
+    {
+        crcReg = crcSwWord2(crcReg, crcSwOrderWord(w[0], order), crcSwOrderWord(w[1], order));
+    }
+#endif
+    for (; words > 0; words--, w++)
+    {
+        crcReg = crcSwWord(crcReg, crcSwOrderWord(*w, order));
+    }
+
+    return crcReg;
+}
+
+static uint32_t crcSwFeed(uint32_t crcReg, const void *data, size_t len, CrcOrder order)
+{
+    const uint8_t *p = data;
+
+    // Bytes before the first word boundary, so the rest can be read as words
+    size_t head = (0u - (uintptr_t)p) & 3u;
+    if (head > len)
+    {
+        head = len;
+    }
+    crcReg = crcSwPartial(crcReg, p, head, order);
+    p += head;
+    len -= head;
+
+    const CrcWord *w = (const CrcWord *)p;
+    size_t words = len / 4;
+
+    // A separate copy of the loop for each order
+    switch (order)
+    {
+    case CRC_ORDER_BYTES:
+        crcReg = crcSwWords(crcReg, w, words, CRC_ORDER_BYTES);
+        break;
+    case CRC_ORDER_HALFWORDS:
+        crcReg = crcSwWords(crcReg, w, words, CRC_ORDER_HALFWORDS);
+        break;
+    default:
+        crcReg = crcSwWords(crcReg, w, words, CRC_ORDER_WORDS);
+        break;
+    }
+    w += words;
+
+    return crcSwPartial(crcReg, (const uint8_t *)w, len & 3, order);
+}
+
+uint32_t crcSwUpdate(uint32_t crcReg, const void *data, size_t len, CrcOrder order)
+{
+    CRC_STATS_START(start);
+    crcReg = crcSwFeed(crcReg, data, len, order);
+    CRC_STATS_END(start, CRC_BACKEND_SW, len);
+    return crcReg;
+}
+
+uint32_t crcSwCalc(const void *data, size_t len, uint32_t initValue, CrcOrder order)
+{
+    return crcSwUpdate(initValue, data, len, order);
+}
+
+// Whole, aligned words of n streams, a word of each in turn.  Called with a
+//  constant n and order, so that c[] can stay in registers.
+static inline void crcSwWordsN(uint32_t *crc, const CrcWord *const *w, unsigned n, size_t words,
+                               CrcOrder order)
+{
+    uint32_t c[CRC_SW_STREAMS];
+
+    for (unsigned k = 0; k < n; k++)
+    {
+        c[k] = crc[k];
+    }
+    for (size_t i = 0; i < words; i++)
+    {
+        for (unsigned k = 0; k < n; k++)
+        {
+            c[k] = crcSwWord(c[k], crcSwOrderWord(w[k][i], order));
+        }
+    }
+    for (unsigned k = 0; k < n; k++)
+    {
+        crc[k] = c[k];
+    }
+}
+
+static inline void crcSwStreamWords(uint32_t *crc, const CrcWord *const *w, unsigned n,
+                                    size_t words, CrcOrder order)
+{
+    switch (n)
+    {
+    case 1:
+        crcSwWordsN(crc, w, 1, words, order);
+        break;
+#if CRC_SW_STREAMS >= 3
+    case 3:
+        crcSwWordsN(crc, w, 3, words, order);
+        break;
+#endif
+#if CRC_SW_STREAMS >= 4
+    case 4:
+        crcSwWordsN(crc, w, 4, words, order);
+        break;
+#endif
+    default:
+        crcSwWordsN(crc, w, 2, words, order);
+        break;
+    }
+}
+
+// Up to CRC_SW_STREAMS streams
+static void crcSwStreamsFeed(CrcSwStream *s, unsigned n, CrcOrder order)
+{
+    const uint8_t *p[CRC_SW_STREAMS];
+    size_t left[CRC_SW_STREAMS];
+    uint32_t crc[CRC_SW_STREAMS];
+
+    for (unsigned k = 0; k < n; k++)
+    {
+        size_t head = (0u - (uintptr_t)s[k].data) & 3u;
+        if (head > s[k].len)
+        {
+            head = s[k].len;
+        }
+        crc[k] = crcSwPartial(s[k].crcReg, s[k].data, head, order);
+        p[k] = (const uint8_t *)s[k].data + head;
+        left[k] = s[k].len - head;
+    }
+
+    // Interleave the streams that have whole words left, for as many words
+    //  as the shortest has, until none have
+    for (;;)
+    {
+        const CrcWord *w[CRC_SW_STREAMS];
+        uint32_t c[CRC_SW_STREAMS];
+        unsigned which[CRC_SW_STREAMS];
+        unsigned m = 0;
+        size_t words = 0;
+
+        for (unsigned k = 0; k < n; k++)
+        {
+            if (left[k] >= 4)
+            {
+                if (m == 0 || left[k] / 4 < words)
+                {
+                    words = left[k] / 4;
+                }
+                w[m] = (const CrcWord *)p[k];
+                c[m] = crc[k];
+                which[m++] = k;
+            }
+        }
+        if (m == 0)
+        {
+            break;
+        }
+
+        // A separate copy of the loops for each order
+        switch (order)
+        {
+        case CRC_ORDER_BYTES:
+            crcSwStreamWords(c, w, m, words, CRC_ORDER_BYTES);
+            break;
+        case CRC_ORDER_HALFWORDS:
+            crcSwStreamWords(c, w, m, words, CRC_ORDER_HALFWORDS);
+            break;
+        default:
+            crcSwStreamWords(c, w, m, words, CRC_ORDER_WORDS);
+            break;
+        }
+
+        for (unsigned j = 0; j < m; j++)
+        {
+            unsigned k = which[j];
+
+            crc[k] = c[j];
+            p[k] += 4 * words;
+            left[k] -= 4 * words;
+        }
+    }
+
+    for (unsigned k = 0; k < n; k++)
+    {
+        s[k].crcReg = crcSwPartial(crc[k], p[k], left[k], order);
+    }
+}
+
+void crcSwUpdateStreams(CrcSwStream *s, unsigned n, CrcOrder order)
+{
+#if CRC_STATS
+    size_t len = 0;
+    for (unsigned k = 0; k < n; k++)
+    {
+        len += s[k].len;
+    }
+#endif
+    CRC_STATS_START(start);
+
+    for (; n > CRC_SW_STREAMS; n -= CRC_SW_STREAMS, s += CRC_SW_STREAMS)
+    {
+        crcSwStreamsFeed(s, CRC_SW_STREAMS, order);
+    }
+    if (n)
+    {
+        crcSwStreamsFeed(s, n, order);
+    }
+    CRC_STATS_END(start, CRC_BACKEND_SW, len);
+}
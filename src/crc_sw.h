@@ -0,0 +1,91 @@
+// crc_sw.h
+//
+// Table-driven software CRC, for parts without the CRC peripheral or for
+// when the peripheral is busy.  Gives exactly the same results as
+// cleverCRC() (CRC_ORDER_BYTES) or the peripheral fed with memory words
+// (CRC_ORDER_WORDS) or halfwords (CRC_ORDER_HALFWORDS), from any starting
+// crcReg value.
+//
+// CRC_SW_SLICE picks the size/speed tradeoff at build time:
+//   0 - one 16-entry table (64 bytes), one table lookup per nibble, for
+//       parts with neither the peripheral nor the flash for a bigger table
+//   1 - one 256-entry table (1 KB), one table lookup per byte
+//   4 - slice-by-4 (4 KB), a word at a time
+//   8 - slice-by-8 (8 KB), two words at a time
+
+#ifndef CRC_SW_H
+#define CRC_SW_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CRC_SW_SLICE
+#define CRC_SW_SLICE 4
+#endif
+
+#if CRC_SW_SLICE != 0 && CRC_SW_SLICE != 1 && CRC_SW_SLICE != 4 && CRC_SW_SLICE != 8
+#error "CRC_SW_SLICE must be 0, 1, 4 or 8"
+#endif
+
+// Generated by tools/crc_tables.py, in crc_sw_tables.c
+#if CRC_SW_SLICE == 0
+extern const uint32_t crcSwNibble[16];
+#else
+extern const uint32_t crcSwTable[CRC_SW_SLICE][256];
+#endif
+
+// One byte, most-significant bit first: what cleverCRC() does in 8 loops.
+//  The nibble table does it in two steps of 4.
+static inline uint32_t crcSwByte(uint32_t crcReg, uint8_t byte)
+{
+#if CRC_SW_SLICE == 0
+    crcReg = (crcReg << 4) ^ crcSwNibble[(crcReg >> 28) ^ (byte >> 4)];
+    return (crcReg << 4) ^ crcSwNibble[(crcReg >> 28) ^ (byte & 0xFu)];
+#else
+    return (crcReg << 8) ^ crcSwTable[0][(crcReg >> 24) ^ byte];
+#endif
+}
+
+// Continue a CRC from crcReg over len bytes of data, in the given order.
+//  For CRC_ORDER_WORDS and CRC_ORDER_HALFWORDS, partial words at the start
+//  and end are handled as described in stm32crc.h.
+uint32_t crcSwUpdate(uint32_t crcReg, const void *data, size_t len, CrcOrder order);
+
+// One-shot software CRC with the given initial value
+uint32_t crcSwCalc(const void *data, size_t len, uint32_t initValue, CrcOrder order);
+
+// Most streams fed in one loop by crcSwUpdateStreams(), 2 to 4
+#ifndef CRC_SW_STREAMS
+#define CRC_SW_STREAMS 4
+#endif
+
+#if CRC_SW_STREAMS < 2 || CRC_SW_STREAMS > 4
+#error "CRC_SW_STREAMS must be 2, 3 or 4"
+#endif
+
+typedef struct
+{
+    const void *data;
+    size_t len;
+    uint32_t crcReg;            // updated by crcSwUpdateStreams()
+} CrcSwStream;
+
+// Continue n independent CRCs, each from its crcReg over its data, as
+//  crcSwUpdate() on each would.  The streams' whole words are fed a word of
+//  each in turn, up to CRC_SW_STREAMS at a time: one stream's CRC depends
+//  on its last table lookup, but the others' don't, so on a dual-issue core
+//  like the Cortex-M7 their loads and XORs can overlap.  To do one buffer
+//  this way, see crcStripeCalcSw() in crc_stripe.h.
+void crcSwUpdateStreams(CrcSwStream *s, unsigned n, CrcOrder order);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_SW_H
@@ -0,0 +1,116 @@
+// crc_xip.c
+//
+// See crc_xip.h
+
+#include "crc_xip.h"
+
+// The one stream in progress
+static struct
+{
+    const uint8_t *next;        // next byte to feed; on a burst boundary
+    size_t len;                 // bytes still to feed
+    CrcDoneFn done;
+    void *arg;
+    volatile int busy;
+} crcXip;
+
+static void crcXipFinish(CrcCtx *ctx)
+{
+    crcXip.busy = 0;
+    crcXip.done(ctx, crcXip.arg);
+}
+
+// Start the next transfer, or finish off with the CPU.  Called again by
+//  crcUpdateDma() when each transfer is done.
+static void crcXipNext(CrcCtx *ctx, void *arg)
+{
+    (void)arg;
+
+    size_t n = crcXip.len;
+    if (n > CRC_XIP_CHUNK)
+    {
+        n = CRC_XIP_CHUNK;
+    }
+    else
+    {
+        n &= ~(size_t)(CRC_XIP_BURST - 1);
+    }
+
+    if (n == 0)
+    {
+        // Part of a burst and the "End Address" bytes
+        crcUpdate(ctx, crcXip.next, crcXip.len);
+        crcXipFinish(ctx);
+        return;
+    }
+
+    // A short last run of bursts may be fed by the CPU, in which case this
+    //  is called again, once, before crcUpdateDma() returns
+    const uint8_t *p = crcXip.next;
+    crcXip.next += n;
+    crcXip.len -= n;
+    crcUpdateDma(ctx, p, n, crcXipNext, NULL);
+}
+
+void crcUpdateXip(CrcCtx *ctx, const void *data, size_t len, CrcDoneFn done, void *arg)
+{
+    const uint8_t *p = data;
+
+    crcXip.done = done;
+    crcXip.arg = arg;
+    crcXip.busy = 1;
+
+    if (ctx->order != CRC_ORDER_WORDS)
+    {
+        crcUpdate(ctx, p, len);
+        crcXipFinish(ctx);
+        return;
+    }
+
+    // "Start Address" and the words up to the first burst boundary
+    size_t lead = (0u - (uintptr_t)p) & (CRC_XIP_BURST - 1);
+    if (lead > len)
+    {
+        lead = len;
+    }
+    crcUpdate(ctx, p, lead);
+    p += lead;
+    len -= lead;
+
+    // crcUpdateDma() would feed a word with pendXor folded in by CPU, which
+    //  would leave the DMA off the burst boundary; feed a whole burst instead
+    if (ctx->pendXor && len >= CRC_XIP_BURST)
+    {
+        crcUpdate(ctx, p, CRC_XIP_BURST);
+        p += CRC_XIP_BURST;
+        len -= CRC_XIP_BURST;
+    }
+
+    crcXip.next = p;
+    crcXip.len = len;
+    crcXipNext(ctx, NULL);
+}
+
+int crcXipBusy(void)
+{
+    return crcXip.busy;
+}
+
+static void crcXipCalcDone(CrcCtx *ctx, void *arg)
+{
+    (void)ctx;
+    *(volatile int *)arg = 1;
+}
+
+uint32_t crcXipCalc(const void *data, size_t len, uint32_t initValue)
+{
+    CrcCtx ctx;
+    volatile int done = 0;
+
+    crcInit(&ctx, initValue, CRC_ORDER_WORDS);
+    crcUpdateXip(&ctx, data, len, crcXipCalcDone, (void *)&done);
+    while (!done)
+    {
+    }
+    return crcFinal(&ctx);
+}
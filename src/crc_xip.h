@@ -0,0 +1,73 @@
+// crc_xip.h
+//
+// DMA-fed CRC of data in memory-mapped external flash (QSPI/OctoSPI in
+// memory-mapped mode, FMC NOR), read in place, with no copy into SRAM.
+//
+// The flash interface fetches whole prefetch lines, and the DMA controller
+// moves data fastest in bursts (MBURST INCR4/8/16 through its FIFO), but a
+// burst may not cross a burst-sized boundary.  So the CPU feeds the data up
+// to the first CRC_XIP_BURST boundary, after which the data goes to
+// crcUpdateDma() in transfers of CRC_XIP_CHUNK bytes that all start on a
+// burst boundary and are a whole number of bursts long.  The remaining
+// part burst and the "End Address" bytes go through the CPU at the end.
+// The CPU reads the head and tail from the mapped addresses as well.
+//
+// crcPortDmaStart() can then set up bursts for any transfer whose source
+// address and length are multiples of CRC_XIP_BURST.  Between transfers the
+// flash interface is free for other bus masters, e.g. code executing in
+// place.
+//
+// As with crc_dma.h, only CRC_ORDER_WORDS is fed by DMA; other orders are
+// fed by the CPU, still straight from the mapped region.
+
+#ifndef CRC_XIP_H
+#define CRC_XIP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stm32crc.h"
+#include "crc_dma.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bytes in one DMA burst (e.g. INCR8 of words); a power of 2
+#ifndef CRC_XIP_BURST
+#define CRC_XIP_BURST 32u
+#endif
+
+// Bytes in one DMA transfer; a multiple of CRC_XIP_BURST, and long enough
+//  for crcUpdateDma() to use the DMA
+#ifndef CRC_XIP_CHUNK
+#define CRC_XIP_CHUNK 16384u
+#endif
+
+#if (CRC_XIP_BURST & (CRC_XIP_BURST - 1)) != 0 || CRC_XIP_BURST < 4
+#error "CRC_XIP_BURST must be a power of 2, at least 4"
+#endif
+
+#if CRC_XIP_CHUNK % CRC_XIP_BURST != 0 || CRC_XIP_CHUNK / 4 > CRC_DMA_MAX_WORDS \
+    || CRC_XIP_CHUNK / 4 <= CRC_DMA_MIN_WORDS
+#error "CRC_XIP_CHUNK must be a multiple of CRC_XIP_BURST, and fit one DMA transfer"
+#endif
+
+// Feed len bytes of mapped data, at any alignment, into the CRC.  Returns
+//  immediately; done is called, from the DMA interrupt, when the CRC has
+//  been updated.  Nothing else may use the peripheral (or crc_dma.c) until
+//  then.
+void crcUpdateXip(CrcCtx *ctx, const void *data, size_t len, CrcDoneFn done, void *arg);
+
+// Non-zero while a crcUpdateXip() is in progress
+int crcXipBusy(void);
+
+// The same, waiting for the result: the CRC of len bytes of mapped data,
+//  in CRC_ORDER_WORDS.  The DMA interrupt must be able to run.
+uint32_t crcXipCalc(const void *data, size_t len, uint32_t initValue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_XIP_H
@@ -0,0 +1,344 @@
+// stm32crc.c
+//
+// See stm32crc.h.  Section names in the comments refer to stm32crc.adoc.
+
+#include "stm32crc.h"
+#include "stm32crc_int.h"
+#include "crc_port.h"
+#include "crc_stats.h"
+
+#if CRC_USE_TAIL_TABLE
+#include "crc_sw.h"
+#endif
+
+// Put n (1..3) bytes, which all lie within one memory word, into the
+//  least-significant bytes of a word in CRC_ORDER_WORDS or
+//  CRC_ORDER_HALFWORDS processing order
+static uint32_t crcGather(const uint8_t *p, unsigned n, CrcOrder order)
+{
+    // Byte positions within a word, in processing order
+    static const uint8_t words[4] = { 3, 2, 1, 0 };
+    static const uint8_t halfwords[4] = { 1, 0, 3, 2 };
+    const uint8_t *seq = (order == CRC_ORDER_HALFWORDS) ? halfwords : words;
+    unsigned first = (uintptr_t)p & 3u;
+    uint32_t bits = 0;
+
+    for (unsigned i = 0; i < 4; i++)
+    {
+        unsigned at = seq[i] - first;   // wraps round if before p
+        if (at < n)
+        {
+            bits = (bits << 8) | p[at];
+        }
+    }
+
+    return bits;
+}
+
+// crc after n bytes, given in the least-significant bytes of bits in
+//  processing order, by table
+#if CRC_USE_TAIL_TABLE
+static uint32_t crcTableBits(uint32_t crc, uint32_t bits, unsigned n)
+{
+    for (unsigned i = n; i > 0; i--)
+    {
+        crc = crcSwByte(crc, (uint8_t)(bits >> (8 * (i - 1))));
+    }
+    return crc;
+}
+#endif
+
+// Process n (1..3) bytes of data, given in the least-significant bytes of
+//  bits.  This is the "End Address" trick, also used for the bytes before the
+//  first word boundary so that any initial value works with any alignment.
+//
+// The doc writes the CRC back to clear crcReg, then writes the padded word.
+//  Writing the XOR of the two instead has the same effect with one write.
+//  The final shift and XOR is left in pendXor, to be folded into the next
+//  full word or the next read.
+//
+// With CRC_TAIL_TABLE the bytes go through crcSwByte() in software instead,
+//  and pendXor takes the difference between the result and the peripheral.
+void crcPartial(CrcCtx *ctx, uint32_t bits, unsigned n)
+{
+    uint32_t hw = CRC_HW_READ();
+    uint32_t crc = hw ^ ctx->pendXor;
+
+#if CRC_USE_TAIL_TABLE
+    if (ctx->tail == CRC_TAIL_TABLE)
+    {
+        ctx->pendXor = hw ^ crcTableBits(crc, bits, n);
+        return;
+    }
+#endif
+
+    CRC_HW_WRITE(hw ^ (crc >> (32 - 8 * n)) ^ bits);
+    ctx->pendXor = crc << (8 * n);
+}
+
+// Append n bytes to the CRC_ORDER_BYTES carry, writing it to the
+//  peripheral each time it fills a word
+static void crcCarryBytes(CrcCtx *ctx, const uint8_t *p, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        ctx->carry = (ctx->carry << 8) | p[i];
+        if (++ctx->carryLen == 4)
+        {
+            CRC_HW_WRITE(ctx->carry ^ ctx->pendXor);
+            ctx->pendXor = 0;
+            ctx->carry = 0;
+            ctx->carryLen = 0;
+        }
+    }
+}
+
+// Feed any carried bytes in with the "End Address" trick
+static void crcFlushCarry(CrcCtx *ctx)
+{
+    if (ctx->carryLen)
+    {
+        crcPartial(ctx, ctx->carry, ctx->carryLen);
+        ctx->carry = 0;
+        ctx->carryLen = 0;
+    }
+}
+
+// One word, as loaded from memory, in the order it is written to the
+//  peripheral: "Quickly Re-ordering Bytes"
+static inline uint32_t crcOrderWord(uint32_t w, CrcOrder order)
+{
+    switch (order)
+    {
+    case CRC_ORDER_BYTES:
+        return crcRev(w);
+    case CRC_ORDER_HALFWORDS:
+        return crcRor16(w);
+    default:
+        return w;
+    }
+}
+
+// Whole, aligned words; the first one carries pendXor.  Four words are
+//  loaded at a time, which GCC does with one LDM, so the REV or ROR is the
+//  only extra work per word over feeding the peripheral from memory.
+static inline void crcFeedWords(const CrcWord *w, size_t words, uint32_t pendXor, CrcOrder order)
+{
+    CRC_HW_WRITE(crcOrderWord(*w++, order) ^ pendXor);
+    words--;
+
+    for (; words >= 4; words -= 4, w += 4)
+    {
+        uint32_t a = w[0];
+        uint32_t b = w[1];
+        uint32_t c = w[2];
+        uint32_t d = w[3];
+        CRC_HW_WRITE(crcOrderWord(a, order));
+        CRC_HW_WRITE(crcOrderWord(b, order));
+        CRC_HW_WRITE(crcOrderWord(c, order));
+        CRC_HW_WRITE(crcOrderWord(d, order));
+    }
+
+    for (; words > 0; words--)
+    {
+        CRC_HW_WRITE(crcOrderWord(*w++, order));
+    }
+}
+
+// A separate copy of the loop for each order, so it isn't switched on per word
+static void crcWriteWords(CrcCtx *ctx, const CrcWord *w, size_t words)
+{
+    switch (ctx->order)
+    {
+    case CRC_ORDER_BYTES:
+        crcFeedWords(w, words, ctx->pendXor, CRC_ORDER_BYTES);
+        break;
+    case CRC_ORDER_HALFWORDS:
+        crcFeedWords(w, words, ctx->pendXor, CRC_ORDER_HALFWORDS);
+        break;
+    default:
+        crcFeedWords(w, words, ctx->pendXor, CRC_ORDER_WORDS);
+        break;
+    }
+    ctx->pendXor = 0;
+    CRC_STATS_INC(cpuFeeds);
+}
+
+void crcInit(CrcCtx *ctx, uint32_t initValue, CrcOrder order)
+{
+    // Reset sets crcReg to 0xFFFFFFFF; see "Changing the Initial Value"
+    CRC_HW_RESET();
+    ctx->pendXor = initValue ^ 0xFFFFFFFFu;
+    ctx->carry = 0;
+    ctx->carryLen = 0;
+    ctx->tail = CRC_TAIL_PERIPHERAL;
+    ctx->order = order;
+}
+
+void crcSetTail(CrcCtx *ctx, CrcTail tail)
+{
+    ctx->tail = (uint8_t)tail;
+}
+
+static void crcFeed(CrcCtx *ctx, const void *data, size_t len)
+{
+    const uint8_t *p = data;
+
+    size_t head = (0u - (uintptr_t)p) & 3u;
+    if (head > len)
+    {
+        head = len;
+    }
+
+    if (ctx->order == CRC_ORDER_BYTES)
+    {
+        // "Start Address": the bytes before the first word boundary join any
+        //  left over from the last call.  If they make a whole word there is
+        //  nothing to fix up, otherwise the rest need the "End Address" trick
+        //  before the aligned words can go in.
+        crcCarryBytes(ctx, p, head);
+        p += head;
+        len -= head;
+
+        size_t words = len / 4;
+        if (words)
+        {
+            if (ctx->carryLen)
+            {
+                CRC_STATS_INC(heads);
+            }
+            crcFlushCarry(ctx);
+            crcWriteWords(ctx, (const CrcWord *)p, words);
+            p += words * 4;
+        }
+
+        // "End Address": kept for the next call or crcFinal()
+        crcCarryBytes(ctx, p, len & 3);
+        return;
+    }
+
+    // "Start Address": bytes before the first word boundary
+    if (head)
+    {
+        CRC_STATS_INC(heads);
+        crcPartial(ctx, crcGather(p, (unsigned)head, ctx->order), (unsigned)head);
+        p += head;
+        len -= head;
+    }
+
+    size_t words = len / 4;
+    if (words)
+    {
+        crcWriteWords(ctx, (const CrcWord *)p, words);
+        p += words * 4;
+        len -= words * 4;
+    }
+
+    // "End Address": 1, 2 or 3 bytes after the last word boundary
+    if (len)
+    {
+        CRC_STATS_INC(tails);
+        crcPartial(ctx, crcGather(p, (unsigned)len, ctx->order), (unsigned)len);
+    }
+}
+
+void crcUpdate(CrcCtx *ctx, const void *data, size_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+
+    CRC_STATS_START(start);
+    crcFeed(ctx, data, len);
+    CRC_STATS_END(start, CRC_BACKEND_HW, len);
+}
+
+void crcUpdateVec(CrcCtx *ctx, const CrcIovec *iov, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        crcUpdate(ctx, iov[i].base, iov[i].len);
+    }
+}
+
+uint32_t crcFinal(CrcCtx *ctx)
+{
+    if (ctx->carryLen)
+    {
+        CRC_STATS_INC(tails);
+    }
+    crcFlushCarry(ctx);
+    return CRC_HW_READ() ^ ctx->pendXor;
+}
+
+uint32_t crcCalc(const void *data, size_t len, uint32_t initValue, CrcOrder order)
+{
+    CrcCtx ctx;
+
+    crcInit(&ctx, initValue, order);
+    crcUpdate(&ctx, data, len);
+    return crcFinal(&ctx);
+}
+
+void crcCalcBatch(const CrcIovec *msg, size_t count, uint32_t initValue, CrcOrder order,
+                  uint32_t *crc)
+{
+    CrcCtx ctx;
+
+    crcInit(&ctx, initValue, order);
+    ctx.tail = CRC_TAIL_TABLE;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint8_t *p = msg[i].base;
+        size_t len = msg[i].len;
+        uint32_t hw;
+        uint32_t r;
+        CRC_STATS_START(start);
+
+#if CRC_USE_TAIL_TABLE
+        // Up to the last word boundary through the peripheral; the bytes
+        //  after it by table, from the one read that gives the CRC
+        size_t tail = (uintptr_t)(p + len) & 3u;
+        if (tail > len)
+        {
+            tail = len;
+        }
+        crcFeed(&ctx, p, len - tail);
+        p += len - tail;
+
+        hw = CRC_HW_READ();
+        r = hw ^ ctx.pendXor;
+        if (tail || ctx.carryLen)
+        {
+            CRC_STATS_INC(tails);
+        }
+        if (order == CRC_ORDER_BYTES)
+        {
+            r = crcTableBits(r, ctx.carry, ctx.carryLen);
+            for (size_t k = 0; k < tail; k++)
+            {
+                r = crcTableBits(r, p[k], 1);
+            }
+        }
+        else if (tail)
+        {
+            r = crcTableBits(r, crcGather(p, (unsigned)tail, order), (unsigned)tail);
+        }
+#else
+        crcFeed(&ctx, p, len);
+        r = crcFinal(&ctx);
+        hw = r ^ ctx.pendXor;
+#endif
+        CRC_STATS_END(start, CRC_BACKEND_HW, len);
+        crc[i] = r;
+
+        // "Changing the Initial Value" without a reset: the peripheral holds
+        //  hw, so the next message starts from initValue if pendXor makes up
+        //  the difference
+        ctx.pendXor = hw ^ initValue;
+        ctx.carry = 0;
+        ctx.carryLen = 0;
+    }
+}
@@ -0,0 +1,142 @@
+// stm32crc.h
+//
+// Streaming CRC calculation using the basic STM32 CRC peripheral (32-bit,
+// polynomial 0x04C11DB7, 32 bits of data at a time, most-significant bit
+// first), using the tricks described in stm32crc.adoc to handle any initial
+// value and data that doesn't start or end on a word boundary.
+//
+// Usage:
+//
+//     CrcCtx ctx;
+//     crcInit(&ctx, 0xFFFFFFFF, CRC_ORDER_BYTES);
+//     crcUpdate(&ctx, buf1, len1);
+//     crcUpdate(&ctx, buf2, len2);
+//     uint32_t crc = crcFinal(&ctx);
+//
+// The running CRC lives in the peripheral between calls, so only one CrcCtx
+// may be in use at a time.
+
+#ifndef STM32CRC_H
+#define STM32CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The order in which data bytes are fed to the CRC calculation.  Within each
+//  byte, bits are always processed most- to least-significant.
+typedef enum
+{
+    // Bytes in increasing address order, as in the doc's examples; each word
+    //  is byte-reversed (REV) before being written to the peripheral.  Gives
+    //  the same result as cleverCRC().
+    CRC_ORDER_BYTES,
+
+    // 32-bit words as they are stored in memory, written to the peripheral
+    //  unchanged.  The bytes of a word are processed from the highest address
+    //  to the lowest.  A partial word at the start or end of the data is
+    //  processed the same way, as if the missing bytes were not there, so
+    //  splitting the data between crcUpdate() calls only gives the same
+    //  result as a single call if the split is on a word boundary.
+    CRC_ORDER_WORDS,
+
+    // 16-bit halfwords (e.g. uint16_t samples) as they are stored in memory,
+    //  in increasing address order; each word has its halfwords swapped
+    //  (ROR #16) before being written to the peripheral.  The bytes of a
+    //  halfword are processed from the higher address to the lower.  Partial
+    //  words, and a lone byte of a halfword, are processed in the same order
+    //  as if the missing bytes were not there, as for CRC_ORDER_WORDS.
+    CRC_ORDER_HALFWORDS
+} CrcOrder;
+
+// How 1 to 3 bytes that don't make up a whole word are processed
+typedef enum
+{
+    // "End Address": one read of the peripheral and one write
+    CRC_TAIL_PERIPHERAL,
+
+    // One read of the peripheral, then crcSwByte() from crc_sw.h for each
+    //  byte in software: one 256-entry table lookup, or two 16-entry ones
+    //  with CRC_SW_SLICE 0.  The result goes into pendXor, so nothing is
+    //  written.
+    //  Avoids waiting for the peripheral to finish a write, which matters
+    //  most for short messages.
+    CRC_TAIL_TABLE
+} CrcTail;
+
+// Set to 0 to leave out CRC_TAIL_TABLE, so that crc_sw_tables.c isn't
+//  needed
+#ifndef CRC_USE_TAIL_TABLE
+#define CRC_USE_TAIL_TABLE 1
+#endif
+
+typedef struct
+{
+    // The CRC calculated so far is the peripheral's data register XOR pendXor.
+    //  pendXor is XORed into the next full word written to the peripheral,
+    //  which is the "Changing the Initial Value" trick.
+    uint32_t pendXor;
+
+    // CRC_ORDER_BYTES only: up to 3 bytes after the last word boundary of
+    //  the previous crcUpdate(), in the least-significant bytes of carry.
+    //  They are combined with the bytes before the next word boundary, so
+    //  data split into pieces needs at most one fixup per piece.
+    uint32_t carry;
+    uint8_t carryLen;
+
+    uint8_t tail;               // CrcTail
+
+    CrcOrder order;
+} CrcCtx;
+
+// One piece of data for crcUpdateVec(), e.g. one pbuf's payload
+typedef struct
+{
+    const void *base;
+    size_t len;
+} CrcIovec;
+
+// Reset the peripheral and start a new CRC with the given initial value.
+//  The initial value is the content of crcReg before the first data bit
+//  is processed, whatever the alignment of the data.
+void crcInit(CrcCtx *ctx, uint32_t initValue, CrcOrder order);
+
+// Choose how partial words are processed from now on; crcInit() sets
+//  CRC_TAIL_PERIPHERAL.  May be changed between crcUpdate() calls.
+void crcSetTail(CrcCtx *ctx, CrcTail tail);
+
+// Feed len bytes of data, at any alignment, into the CRC
+void crcUpdate(CrcCtx *ctx, const void *data, size_t len);
+
+// Feed count pieces of data, in order, into the CRC without copying them
+//  together.  For CRC_ORDER_BYTES, bytes left over at the end of one piece
+//  are carried into the next, and each piece's aligned words go straight to
+//  the peripheral.
+void crcUpdateVec(CrcCtx *ctx, const CrcIovec *iov, size_t count);
+
+// Return the CRC of all the data fed in since crcInit().  Any carried bytes
+//  are fed in first; more data may be fed in afterwards.  Because of that
+//  ctx isn't const, as it was before crcUpdateVec() and the carry.
+uint32_t crcFinal(CrcCtx *ctx);
+
+// One-shot CRC calculation: crcInit(), crcUpdate(), crcFinal()
+uint32_t crcCalc(const void *data, size_t len, uint32_t initValue, CrcOrder order);
+
+// crcCalc() of each of count messages, e.g. short frames, into crc[0] to
+//  crc[count - 1].  The peripheral is reset once for the whole batch: each
+//  message's CRC is read out once, and the next message is seeded by
+//  folding the difference into pendXor ("Changing the Initial Value").
+//  With CRC_USE_TAIL_TABLE, the bytes after each message's last word
+//  boundary, and any unaligned head, are done by table, so the peripheral
+//  is only written with whole words.
+void crcCalcBatch(const CrcIovec *msg, size_t count, uint32_t initValue, CrcOrder order,
+                  uint32_t *crc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32CRC_H
@@ -0,0 +1,328 @@
+// stm32crc.hpp
+//
+// Compile-time CRC parameter sets, using the model from "Common Variations
+// on CRC Computations" in stm32crc.adoc: width, polynomial, initial value,
+// input bit order, output bit order and final XOR.
+//
+//     using Modbus = stm32crc::Crc<16, 0x8005, 0xFFFF, true, true, 0>;
+//     uint16_t crc = Modbus::calc(frame, len);
+//
+// The lookup table for each parameter set is built by the compiler, so it
+// is const data in flash with no startup cost, and the conversions between
+// the parameters and the shift register (initial value alignment and
+// reflection, output reflection, final XOR) are folded into constants.
+//
+// Parameter sets the basic peripheral can do (32 bits wide, polynomial
+// 0x04C11DB7, most-significant bit first) can also be calculated with it
+// using hwCalc().
+//
+// For buffers whose alignment and length are known at compile time, such
+// as statically allocated structs, calcFixed<Align, Len, Order>() does the
+// same as crcCalc() with the "Start Address" and "End Address" decisions
+// made by the compiler: no head when Align is a multiple of 4, and the
+// exact tail sequence for Len % 4, with short buffers fully unrolled.
+//
+//     static Frame frame;
+//     uint32_t crc = stm32crc::calcObject(frame);
+//
+// Needs C++14.
+
+#ifndef STM32CRC_HPP
+#define STM32CRC_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "stm32crc.h"
+#include "crc_port.h"
+
+namespace stm32crc
+{
+
+// Buffers of up to this many words are fed without a loop by calcFixed()
+#ifndef CRC_FIXED_UNROLL
+#define CRC_FIXED_UNROLL 16u
+#endif
+
+namespace detail
+{
+
+// One memory word in the order it goes to the peripheral
+template <CrcOrder Order>
+inline uint32_t orderWord(uint32_t w)
+{
+    return (Order == CRC_ORDER_BYTES) ? crcRev(w)
+         : (Order == CRC_ORDER_HALFWORDS) ? crcRor16(w)
+         : w;
+}
+
+// Words I to N - 1, one write each
+template <CrcOrder Order, size_t I, size_t N>
+struct Words
+{
+    static inline void feed(const CrcWord *w)
+    {
+        CRC_HW_WRITE(orderWord<Order>(w[I]));
+        Words<Order, I + 1, N>::feed(w);
+    }
+};
+
+template <CrcOrder Order, size_t N>
+struct Words<Order, N, N>
+{
+    static inline void feed(const CrcWord *)
+    {
+    }
+};
+
+template <CrcOrder Order, size_t N>
+inline void feedWords(const CrcWord *w, std::true_type)
+{
+    Words<Order, 1, N>::feed(w);
+}
+
+template <CrcOrder Order, size_t N>
+inline void feedWords(const CrcWord *w, std::false_type)
+{
+    for (size_t i = 1; i < N; i++)
+    {
+        CRC_HW_WRITE(orderWord<Order>(w[i]));
+    }
+}
+
+// The N (1..3) bytes at the start of a word, in processing order, in the
+//  least-significant bytes; the positions in the word are as in crcGather()
+template <CrcOrder Order, unsigned N>
+inline uint32_t gatherTail(const uint8_t *p)
+{
+    uint32_t bits = 0;
+    for (unsigned i = 0; i < 4; i++)
+    {
+        unsigned at = (Order == CRC_ORDER_BYTES) ? i
+                    : (Order == CRC_ORDER_HALFWORDS) ? (i ^ 1u)
+                    : 3 - i;
+        if (at < N)
+        {
+            bits = (bits << 8) | p[at];
+        }
+    }
+    return bits;
+}
+
+} // namespace detail
+
+// crcCalc() of Len bytes at data, which is aligned to Align bytes.  If
+//  Align isn't a multiple of 4 the head and tail depend on the address, so
+//  this is just crcCalc().
+template <unsigned Align, size_t Len, CrcOrder Order = CRC_ORDER_BYTES>
+inline uint32_t calcFixed(const void *data, uint32_t initValue = 0xFFFFFFFFu)
+{
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0, "Align must be a power of 2");
+
+    if (Align % 4 != 0)
+    {
+        return crcCalc(data, Len, initValue, Order);
+    }
+
+    constexpr size_t words = Len / 4;
+    constexpr size_t fed = words ? words : 1;       // keeps Words<> in range
+    constexpr unsigned tail = Len % 4;
+    const CrcWord *w = static_cast<const CrcWord *>(data);
+    uint32_t pendXor = initValue ^ 0xFFFFFFFFu;
+
+    // "Changing the Initial Value"
+    CRC_HW_RESET();
+    if (words)
+    {
+        CRC_HW_WRITE(detail::orderWord<Order>(w[0]) ^ pendXor);
+        pendXor = 0;
+        detail::feedWords<Order, fed>(w, std::integral_constant<bool, (fed <= CRC_FIXED_UNROLL)>());
+    }
+
+    // "End Address", with the shifts known
+    if (tail)
+    {
+        constexpr unsigned n = tail ? tail : 1;     // keeps the shifts in range
+        uint32_t bits = detail::gatherTail<Order, n>(reinterpret_cast<const uint8_t *>(w + words));
+        uint32_t hw = CRC_HW_READ();
+        uint32_t crc = hw ^ pendXor;
+        CRC_HW_WRITE(hw ^ (crc >> (32 - 8 * n)) ^ bits);
+        pendXor = crc << (8 * n);
+    }
+    return CRC_HW_READ() ^ pendXor;
+}
+
+// calcFixed() of a whole object, e.g. a statically allocated struct
+template <CrcOrder Order = CRC_ORDER_BYTES, typename T>
+inline uint32_t calcObject(const T &obj, uint32_t initValue = 0xFFFFFFFFu)
+{
+    return calcFixed<alignof(T), sizeof(T), Order>(&obj, initValue);
+}
+
+// Reverse the order of the low width bits of x
+constexpr uint32_t reflect(uint32_t x, unsigned width)
+{
+    uint32_t r = 0;
+    for (unsigned i = 0; i < width; i++)
+    {
+        r = (r << 1) | ((x >> i) & 1u);
+    }
+    return r;
+}
+
+template <unsigned Width, uint32_t Poly, uint32_t Init, bool RefIn, bool RefOut, uint32_t XorOut>
+class Crc
+{
+    static_assert(Width >= 1 && Width <= 32, "CRC width must be 1 to 32 bits");
+
+public:
+    struct Table
+    {
+        uint32_t v[256];
+    };
+
+    static constexpr uint32_t mask = (Width == 32) ? 0xFFFFFFFFu : ((1u << (Width % 32)) - 1u);
+
+    // The shift register is 32 bits.  Most-significant-bit-first CRCs keep
+    //  the CRC in the top Width bits, so the code is the same as cleverCRC()
+    //  for every width; reflected CRCs keep it reversed in the bottom bits.
+    static constexpr uint32_t regPoly = RefIn ? reflect(Poly & mask, Width)
+                                              : (Poly & mask) << (32 - Width);
+    static constexpr uint32_t regInit = RefIn ? reflect(Init & mask, Width)
+                                              : (Init & mask) << (32 - Width);
+
+private:
+    static constexpr Table makeTable()
+    {
+        Table t{};
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t r = RefIn ? i : (i << 24);
+            for (int bit = 0; bit < 8; bit++)
+            {
+                if (RefIn)
+                {
+                    r = (r & 1u) ? (r >> 1) ^ regPoly : (r >> 1);
+                }
+                else
+                {
+                    r = (r & 0x80000000u) ? (r << 1) ^ regPoly : (r << 1);
+                }
+            }
+            t.v[i] = r;
+        }
+        return t;
+    }
+
+    static constexpr uint32_t updateByte(uint32_t reg, uint8_t byte)
+    {
+        return RefIn ? (reg >> 8) ^ table.v[(reg ^ byte) & 0xFFu]
+                     : (reg << 8) ^ table.v[(reg >> 24) ^ byte];
+    }
+
+    static constexpr uint32_t updateBytes(uint32_t reg, const uint8_t *p, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            reg = updateByte(reg, p[i]);
+        }
+        return reg;
+    }
+
+    // The CRC in the low Width bits, in the requested output bit order
+    static constexpr uint32_t outAligned(uint32_t reg)
+    {
+        return RefIn ? (RefOut ? reg : reflect(reg, Width))
+                     : (RefOut ? reflect(reg >> (32 - Width), Width) : reg >> (32 - Width));
+    }
+
+    static constexpr uint32_t checkValue()
+    {
+        const char digits[] = "123456789";
+        uint32_t reg = regInit;
+        for (size_t i = 0; i < 9; i++)
+        {
+            reg = updateByte(reg, static_cast<uint8_t>(digits[i]));
+        }
+        return finish(reg);
+    }
+
+public:
+    // Start a calculation; pass the result to update(), then finish()
+    static constexpr uint32_t begin()
+    {
+        return regInit;
+    }
+
+    static uint32_t update(uint32_t reg, const void *data, size_t len)
+    {
+        return updateBytes(reg, static_cast<const uint8_t *>(data), len);
+    }
+
+    // Shift register to final CRC value
+    static constexpr uint32_t finish(uint32_t reg)
+    {
+        return (outAligned(reg) ^ XorOut) & mask;
+    }
+
+    static uint32_t calc(const void *data, size_t len)
+    {
+        return finish(update(begin(), data, len));
+    }
+
+    // The standard check value: the CRC of the ASCII string "123456789"
+    static constexpr uint32_t check = checkValue();
+
+    // Whether the basic CRC peripheral can calculate this CRC
+    static constexpr bool peripheralCompatible = Width == 32 && Poly == 0x04C11DB7u && !RefIn;
+
+    // Calculate the CRC with the peripheral, bytes in address order.  The
+    //  peripheral's initial value and output conversion are constants here.
+    static uint32_t hwCalc(const void *data, size_t len)
+    {
+        static_assert(peripheralCompatible, "the basic CRC peripheral can't calculate this CRC");
+
+        CrcCtx ctx;
+        crcInit(&ctx, Init, CRC_ORDER_BYTES);
+        crcUpdate(&ctx, data, len);
+        return finish(crcFinal(&ctx));
+    }
+
+    // The same, for Len bytes aligned to Align; see calcFixed()
+    template <unsigned Align, size_t Len>
+    static uint32_t hwCalcFixed(const void *data)
+    {
+        static_assert(peripheralCompatible, "the basic CRC peripheral can't calculate this CRC");
+
+        return finish(calcFixed<Align, Len, CRC_ORDER_BYTES>(data, Init));
+    }
+
+    static constexpr Table table = makeTable();
+};
+
+template <unsigned Width, uint32_t Poly, uint32_t Init, bool RefIn, bool RefOut, uint32_t XorOut>
+constexpr typename Crc<Width, Poly, Init, RefIn, RefOut, XorOut>::Table
+    Crc<Width, Poly, Init, RefIn, RefOut, XorOut>::table;
+
+// Some common parameter sets, named as in the usual CRC catalogues
+using Crc32Mpeg2 = Crc<32, 0x04C11DB7u, 0xFFFFFFFFu, false, false, 0x00000000u>;   // the basic peripheral
+using Crc32Bzip2 = Crc<32, 0x04C11DB7u, 0xFFFFFFFFu, false, false, 0xFFFFFFFFu>;
+using Crc32      = Crc<32, 0x04C11DB7u, 0xFFFFFFFFu, true,  true,  0xFFFFFFFFu>;   // zlib, Ethernet
+using Crc32C     = Crc<32, 0x1EDC6F41u, 0xFFFFFFFFu, true,  true,  0xFFFFFFFFu>;   // Castagnoli
+using Crc16Ccitt = Crc<16, 0x1021u,     0xFFFFu,     false, false, 0x0000u>;       // CCITT-FALSE
+using Crc16Modbus = Crc<16, 0x8005u,    0xFFFFu,     true,  true,  0x0000u>;
+using Crc8Smbus  = Crc<8,  0x07u,       0x00u,       false, false, 0x00u>;
+
+static_assert(Crc32Mpeg2::check == 0x0376E6E7u, "CRC-32/MPEG-2 check");
+static_assert(Crc32Bzip2::check == 0xFC891918u, "CRC-32/BZIP2 check");
+static_assert(Crc32::check == 0xCBF43926u, "CRC-32 check");
+static_assert(Crc32C::check == 0xE3069283u, "CRC-32C check");
+static_assert(Crc16Ccitt::check == 0x29B1u, "CRC-16/CCITT-FALSE check");
+static_assert(Crc16Modbus::check == 0x4B37u, "CRC-16/MODBUS check");
+static_assert(Crc8Smbus::check == 0xF4u, "CRC-8/SMBUS check");
+
+} // namespace stm32crc
+
+#endif // STM32CRC_HPP
@@ -0,0 +1,17 @@
+// stm32crc_int.h
+//
+// Internals of stm32crc.c shared with the other peripheral drivers.  Not
+// part of the public API.
+
+#ifndef STM32CRC_INT_H
+#define STM32CRC_INT_H
+
+#include <stdint.h>
+
+#include "stm32crc.h"
+
+// Process n (1..3) bytes of data, given in the least-significant bytes of
+//  bits in the order they are to be processed, using the "End Address" trick
+void crcPartial(CrcCtx *ctx, uint32_t bits, unsigned n);
+
+#endif // STM32CRC_INT_H
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+#
+# Make the per-sector CRC index for src/crc_image.c from a firmware image.
+#
+# The image is padded with 0xFF (erased flash) to a multiple of 4 bytes.
+# Each sector's CRC is what the peripheral gives for its words, from
+# 0xFFFFFFFF, and the index is written little-endian, as crc_image.h lays
+# it out, to be programmed next to the image.
+#
+# Usage: tools/crc_image_index.py image.bin sector_size index.bin
+
+import struct
+import sys
+
+POLY = 0x04C11DB7
+MAGIC = 0x58444943
+
+
+def make_table():
+    t = []
+    for i in range(256):
+        crc_reg = i << 24
+        for _ in range(8):
+            pop = crc_reg & 0x80000000
+            crc_reg = (crc_reg << 1) & 0xFFFFFFFF
+            if pop:
+                crc_reg ^= POLY
+        t.append(crc_reg)
+    return t
+
+
+TABLE = make_table()
+
+
+def words_crc(data):
+    # Each little-endian word is fed most significant byte first
+    crc_reg = 0xFFFFFFFF
+    for i in range(0, len(data), 4):
+        for b in reversed(data[i:i + 4]):
+            crc_reg = ((crc_reg << 8) & 0xFFFFFFFF) ^ TABLE[(crc_reg >> 24) ^ b]
+    return crc_reg
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit("usage: crc_image_index.py image.bin sector_size index.bin")
+    with open(sys.argv[1], "rb") as f:
+        image = f.read()
+    sector_size = int(sys.argv[2], 0)
+    if sector_size <= 0 or sector_size % 4:
+        sys.exit("sector_size must be a positive multiple of 4")
+
+    image += b"\xff" * (-len(image) % 4)
+    sectors = [image[i:i + sector_size] for i in range(0, len(image), sector_size)]
+
+    index = struct.pack("<5I", MAGIC, len(image), sector_size, len(sectors), words_crc(image))
+    index += b"".join(struct.pack("<I", words_crc(s)) for s in sectors)
+    with open(sys.argv[3], "wb") as f:
+        f.write(index)
+
+
+if __name__ == "__main__":
+    main()
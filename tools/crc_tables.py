@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+#
+# Generate src/crc_sw_tables.c, the lookup tables for crc_sw.c.
+#
+# Table 0 entry i is the change to crcReg from feeding the byte i into
+# cleverCRC() with crcReg starting at zero.  Table k entry i is the same
+# followed by k zero bytes, which is what slice-by-N needs.  The nibble
+# table, for CRC_SW_SLICE 0, is the same for 4 bits.
+#
+# Usage: tools/crc_tables.py > src/crc_sw_tables.c
+
+POLY = 0x04C11DB7
+SLICES = 8
+
+
+def clever_bits(crc_reg, bits):
+    for _ in range(bits):
+        pop = crc_reg & 0x80000000
+        crc_reg = (crc_reg << 1) & 0xFFFFFFFF
+        if pop:
+            crc_reg ^= POLY
+    return crc_reg
+
+
+def tables():
+    t = [[clever_bits(i << 24, 8) for i in range(256)]]
+    for k in range(1, SLICES):
+        t.append([((v << 8) & 0xFFFFFFFF) ^ t[0][v >> 24] for v in t[k - 1]])
+    return t
+
+
+def main():
+    t = tables()
+    print("// crc_sw_tables.c")
+    print("//")
+    print("// Lookup tables for crc_sw.c, polynomial 0x%08X." % POLY)
+    print("// Generated by tools/crc_tables.py; do not edit.")
+    print()
+    print('#include "crc_sw.h"')
+    print()
+    print("#if CRC_SW_SLICE == 0")
+    print("const uint32_t crcSwNibble[16] =")
+    print("{")
+    nibble = [clever_bits(i << 28, 4) for i in range(16)]
+    for row in range(0, 16, 4):
+        print("    %s," % ", ".join("0x%08X" % v for v in nibble[row:row + 4]))
+    print("};")
+    print("#else")
+    print("const uint32_t crcSwTable[CRC_SW_SLICE][256] =")
+    print("{")
+    for k in range(SLICES):
+        if k == 1:
+            print("#if CRC_SW_SLICE >= 4")
+        if k == 4:
+            print("#if CRC_SW_SLICE >= 8")
+        print("    {")
+        for row in range(0, 256, 4):
+            vals = ", ".join("0x%08X" % v for v in t[k][row:row + 4])
+            print("        %s," % vals)
+        print("    },")
+        if k == 7:
+            print("#endif")
+            print("#endif")
+    print("};")
+    print("#endif")
+
+
+if __name__ == "__main__":
+    main()